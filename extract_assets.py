@@ -15,10 +15,29 @@ def read_local_asset_list(f):
         return []
     ret = []
     for line in f:
-        ret.append(line.strip())
+        ret.append(line.strip().split("\t")[0])
     return ret
 
 
+def read_local_asset_hashes(f):
+    # Maps each asset to the hash of the assets.json entry it was extracted
+    # from. Files older than version 8 have no hashes.
+    if f is None:
+        return {}
+    ret = {}
+    for line in f:
+        parts = line.strip().split("\t")
+        if len(parts) == 2:
+            ret[parts[0]] = parts[1]
+    return ret
+
+
+def asset_entry_hash(data):
+    import hashlib
+
+    return hashlib.sha1(json.dumps(data, sort_keys=True).encode()).hexdigest()[:16]
+
+
 def asset_needs_update(asset, version):
     if version <= 6 and asset in ["actors/king_bobomb/king_bob-omb_eyes.rgba16.png", "actors/king_bobomb/king_bob-omb_hand.rgba16.png"]:
         return True
@@ -46,9 +65,9 @@ def remove_file(fname):
         pass
 
 
-def clean_assets(local_asset_file):
+def clean_assets(local_asset_lines):
     assets = set(read_asset_map().keys())
-    assets.update(read_local_asset_list(local_asset_file))
+    assets.update(read_local_asset_list(local_asset_lines))
     for fname in list(assets) + [".assets-local.txt"]:
         if fname.startswith("@"):
             continue
@@ -61,19 +80,21 @@ def clean_assets(local_asset_file):
 def main():
     # In case we ever need to change formats of generated files, we keep a
     # revision ID in the local asset file.
-    new_version = 7
+    new_version = 8
 
     try:
         local_asset_file = open(".assets-local.txt")
         local_asset_file.readline()
         local_version = int(local_asset_file.readline().strip())
+        local_asset_lines = local_asset_file.readlines()
     except Exception:
         local_asset_file = None
         local_version = -1
+        local_asset_lines = None
 
     langs = sys.argv[1:]
     if langs == ["--clean"]:
-        clean_assets(local_asset_file)
+        clean_assets(local_asset_lines)
         sys.exit(0)
 
     all_langs = ["jp", "us", "eu", "sh", "cn"]
@@ -84,11 +105,17 @@ def main():
         sys.exit(1)
 
     asset_map = read_asset_map()
+    local_hashes = read_local_asset_hashes(local_asset_lines)
     all_assets = []
+    asset_hashes = {}
     any_missing_assets = False
+    any_changed_assets = False
     for asset, data in asset_map.items():
         if asset.startswith("@"):
             continue
+        asset_hashes[asset] = asset_entry_hash(data)
+        if asset_hashes[asset] != local_hashes.get(asset, asset_hashes[asset]):
+            any_changed_assets = True
         if os.path.isfile(asset):
             all_assets.append((asset, data, True))
         else:
@@ -96,7 +123,7 @@ def main():
             if not any_missing_assets and any(lang in data[-1] for lang in langs):
                 any_missing_assets = True
 
-    if not any_missing_assets and local_version == new_version:
+    if not any_missing_assets and not any_changed_assets and local_version == new_version:
         # Nothing to do, no need to read a ROM. For efficiency we don't check
         # the list of old assets either.
         return
@@ -105,11 +132,15 @@ def main():
     import subprocess
     import hashlib
     import tempfile
+    import mmap
+    import time
     from collections import defaultdict
+    from concurrent.futures import ThreadPoolExecutor
 
+    start_time = time.monotonic()
     new_assets = {a[0] for a in all_assets}
 
-    previous_assets = read_local_asset_list(local_asset_file)
+    previous_assets = read_local_asset_list(local_asset_lines)
     if local_version == -1:
         # If we have no local asset file, we assume that files are version
         # controlled and thus up to date.
@@ -117,9 +148,12 @@ def main():
 
     # Create work list
     todo = defaultdict(lambda: [])
+    queued_assets = set()
     for (asset, data, exists) in all_assets:
-        # Leave existing assets alone if they have a compatible version.
-        if exists and not asset_needs_update(asset, local_version):
+        # Leave existing assets alone if they have a compatible version and
+        # their assets.json entry is unchanged.
+        changed = asset_hashes[asset] != local_hashes.get(asset, asset_hashes[asset])
+        if exists and not changed and not asset_needs_update(asset, local_version):
             continue
 
         meta = data[:-2]
@@ -129,6 +163,7 @@ def main():
             pos = pos[-1]
             if lang in langs:
                 todo[(lang, mio0)].append((asset, pos, size, meta))
+                queued_assets.add(asset)
                 break
 
     # Load ROMs
@@ -137,7 +172,7 @@ def main():
         fname = "baserom." + lang + ".z64"
         try:
             with open(fname, "rb") as f:
-                roms[lang] = f.read()
+                roms[lang] = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
         except Exception as e:
             print("Failed to open " + fname + "! " + str(e))
             sys.exit(1)
@@ -167,104 +202,116 @@ def main():
     # mio0 file still go together).
     keys = sorted(list(todo.keys()), key=lambda k: todo[k][0][0])
 
-    # Import new assets
-    for key in keys:
-        assets = todo[key]
-        lang, mio0 = key
-        if mio0 == "@sound":
-            rom = roms[lang]
-            args = [
-                "python3",
-                "tools/disassemble_sound.py",
-                "baserom." + lang + ".z64",
-            ]
-            def append_args(key):
-                sound_ver = "sh" if lang == "cn" else lang
-                size, locs = asset_map["@sound " + key + " " + sound_ver]
-                offset = locs[lang][0]
-                args.append(str(offset))
-                args.append(str(size))
-            append_args("ctl")
-            append_args("tbl")
-            if lang in ("sh", "cn"):
-                args.append("--shindou-headers")
-                append_args("ctl header")
-                append_args("tbl header")
-            args.append("--only-samples")
-            for (asset, pos, size, meta) in assets:
-                print("extracting", asset)
-                args.append(asset + ":" + str(pos))
-            subprocess.run(args, check=True)
-            continue
-
-        if mio0 is not None:
-            image = subprocess.run(
-                [
-                    "./tools/sm64tools/mio0",
-                    "-d",
-                    "-o",
-                    str(mio0),
-                    "baserom." + lang + ".z64",
-                    "-",
-                ],
-                check=True,
-                stdout=subprocess.PIPE,
-            ).stdout
-        else:
-            image = roms[lang]
-
+    def extract_sound(lang, assets):
+        args = [
+            "python3",
+            "tools/disassemble_sound.py",
+            "baserom." + lang + ".z64",
+        ]
+        def append_args(key):
+            sound_ver = "sh" if lang == "cn" else lang
+            size, locs = asset_map["@sound " + key + " " + sound_ver]
+            offset = locs[lang][0]
+            args.append(str(offset))
+            args.append(str(size))
+        append_args("ctl")
+        append_args("tbl")
+        if lang in ("sh", "cn"):
+            args.append("--shindou-headers")
+            append_args("ctl header")
+            append_args("tbl header")
+        args.append("--only-samples")
         for (asset, pos, size, meta) in assets:
             print("extracting", asset)
-            input = image[pos : pos + size]
-            os.makedirs(os.path.dirname(asset), exist_ok=True)
-            if asset.endswith(".png"):
-                png_file = tempfile.NamedTemporaryFile(prefix="asset", delete=False)
-                try:
-                    png_file.write(input)
-                    png_file.flush()
-                    png_file.close()
-                    if asset.startswith("textures/skyboxes/") or asset.startswith("levels/ending/cake"):
-                        if asset.startswith("textures/skyboxes/"):
-                            imagetype = "sky"
-                        else:
-                            imagetype = "cake" + ("-cn" if "cn" in asset else "-eu" if "eu" in asset else "")
-                        print(imagetype, png_file.name, asset)
-                        subprocess.run(
-                            [
-                                "./tools/skyconv",
-                                "--type",
-                                imagetype,
-                                "--combine",
-                                png_file.name,
-                                asset,
-                            ],
-                            check=True,
-                        )
+            args.append(asset + ":" + str(pos))
+        subprocess.run(args, check=True)
+
+    def extract_asset(asset, input, meta):
+        print("extracting", asset)
+        os.makedirs(os.path.dirname(asset), exist_ok=True)
+        if asset.endswith(".png"):
+            png_file = tempfile.NamedTemporaryFile(prefix="asset", delete=False)
+            try:
+                png_file.write(input)
+                png_file.flush()
+                png_file.close()
+                if asset.startswith("textures/skyboxes/") or asset.startswith("levels/ending/cake"):
+                    if asset.startswith("textures/skyboxes/"):
+                        imagetype = "sky"
                     else:
-                        w, h = meta
-                        fmt = asset.split(".")[-2]
-                        subprocess.run(
-                            [
-                                "./tools/sm64tools/n64graphics",
-                                "-e",
-                                png_file.name,
-                                "-g",
-                                asset,
-                                "-f",
-                                fmt,
-                                "-w",
-                                str(w),
-                                "-h",
-                                str(h),
-                            ],
-                            check=True,
-                        )
-                finally:
-                    png_file.close()
-                    os.remove(png_file.name)
+                        imagetype = "cake" + ("-cn" if "cn" in asset else "-eu" if "eu" in asset else "")
+                    print(imagetype, png_file.name, asset)
+                    subprocess.run(
+                        [
+                            "./tools/skyconv",
+                            "--type",
+                            imagetype,
+                            "--combine",
+                            png_file.name,
+                            asset,
+                        ],
+                        check=True,
+                    )
+                else:
+                    w, h = meta
+                    fmt = asset.split(".")[-2]
+                    subprocess.run(
+                        [
+                            "./tools/sm64tools/n64graphics",
+                            "-e",
+                            png_file.name,
+                            "-g",
+                            asset,
+                            "-f",
+                            fmt,
+                            "-w",
+                            str(w),
+                            "-h",
+                            str(h),
+                        ],
+                        check=True,
+                    )
+            finally:
+                png_file.close()
+                os.remove(png_file.name)
+        else:
+            with open(asset, "wb") as f:
+                f.write(input)
+
+    # Import new assets. Each asset goes to its own file and the conversions
+    # are separate processes, so they can all run at once.
+    num_extracted = 0
+    with ThreadPoolExecutor(max_workers=os.cpu_count()) as executor:
+        jobs = []
+        for key in keys:
+            assets = todo[key]
+            lang, mio0 = key
+            num_extracted += len(assets)
+            if mio0 == "@sound":
+                jobs.append(executor.submit(extract_sound, lang, assets))
+                continue
+
+            if mio0 is not None:
+                image = subprocess.run(
+                    [
+                        "./tools/sm64tools/mio0",
+                        "-d",
+                        "-o",
+                        str(mio0),
+                        "baserom." + lang + ".z64",
+                        "-",
+                    ],
+                    check=True,
+                    stdout=subprocess.PIPE,
+                ).stdout
             else:
-                with open(asset, "wb") as f:
-                    f.write(input)
+                image = roms[lang]
+
+            for (asset, pos, size, meta) in assets:
+                jobs.append(executor.submit(extract_asset, asset, image[pos : pos + size], meta))
+
+        for job in jobs:
+            job.result()
 
     # Remove old assets
     for asset in previous_assets:
@@ -274,17 +321,26 @@ def main():
             except FileNotFoundError:
                 pass
 
-    # Replace the asset list
+    # Replace the asset list. Assets that were not extracted keep the hash they
+    # were last extracted with, so a changed entry is still picked up by a later
+    # run with one of its versions.
+    def recorded_hash(asset):
+        if asset in queued_assets:
+            return asset_hashes[asset]
+        return local_hashes.get(asset, asset_hashes[asset])
+
     output = "\n".join(
         [
             "# This file tracks the assets currently extracted by extract_assets.py.",
             str(new_version),
-            *sorted(list(new_assets)),
+            *(asset + "\t" + recorded_hash(asset) for asset in sorted(list(new_assets))),
             "",
         ]
     )
     with open(".assets-local.txt", "w") as f:
         f.write(output)
 
+    print("extracted %d assets in %.2fs" % (num_extracted, time.monotonic() - start_time))
+
 
 main()
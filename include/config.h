@@ -34,6 +34,20 @@
 // Support Rumble Pak
 #define ENABLE_RUMBLE (0 || VERSION_SH || VERSION_CN)
 
+// Performance Options
+/// Start the next frame's game logic right after the buffer swap instead of one
+/// vblank later, so it overlaps the RSP/RDP executing the frame just submitted
+#define PIPELINE_GAME_LOOP 0
+/// Record nested timing zones for the main subsystems and stream them to the
+/// host over the USB channel (see tools/profiler_zones.py)
+#define PROFILER_ZONES 0
+/// Accumulate the cycles spent updating each behavior and rank the most
+/// expensive ones on the profiler screen (see tools/behavior_costs.py)
+#define PROFILER_BEHAVIORS 0
+/// Hash the game state after every frame of demo playback, so that two builds can
+/// be checked for identical behavior (see tools/state_hashes.py)
+#define STATE_HASH 0
+
 // Screen Size Defines
 #define SCREEN_WIDTH 320
 #define SCREEN_HEIGHT 240
@@ -12,6 +12,13 @@
 #define READ_USB_Y_ADDR (READ_USB_X_ADDR + 4)
 #define READ_USB_Z_ADDR (READ_USB_Y_ADDR + 4)
 
+// Profiler zone events (PROFILER_ZONES) as a ring of 8-byte ProfilerZoneEvents.
+// The count is the number of events written so far, and event n is found at
+// PROFILER_USB_RING_ADDR + (n % PROFILER_USB_RING_SIZE) * 8.
+#define PROFILER_USB_COUNT_ADDR (CART_SRAM_START + 0x20)
+#define PROFILER_USB_RING_ADDR (CART_SRAM_START + 0x40)
+#define PROFILER_USB_RING_SIZE 128
+
 #define WAIT_ON_IO_BUSY(stat)                                                                          \
     stat = IO_READ(PI_STATUS_REG);                                                                     \
     while (stat & (PI_STATUS_IO_BUSY | PI_STATUS_DMA_BUSY))                                            \
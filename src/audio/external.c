@@ -141,6 +141,7 @@ s32 sDialogSpeakerVoice[] = {
 
 u8 sNumProcessedSoundRequests = 0;
 u8 sSoundRequestCount = 0;
+u32 sNumDroppedSoundRequests = 0; // only used for debugging
 
 // Music dynamic tables. A dynamic describes which volumes to apply to which
 // channels of a sequence (I think?), and different parts of a level can have
@@ -814,6 +815,14 @@ struct SPTask *create_next_audio_frame_task(void) {
  * Called from threads: thread5_game_loop
  */
 void play_sound(s32 soundBits, f32 *pos) {
+    // sSoundRequests is a ring indexed by the u8 counters. If the game thread is
+    // about to lap the sound thread, drop the new request; otherwise the counters
+    // would become equal and every pending request would be lost.
+    if ((u8)(sSoundRequestCount + 1) == sNumProcessedSoundRequests) {
+        sNumDroppedSoundRequests++;
+        return;
+    }
+
     sSoundRequests[sSoundRequestCount].soundBits = soundBits;
     sSoundRequests[sSoundRequestCount].position = pos;
     sSoundRequestCount++;
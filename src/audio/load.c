@@ -49,6 +49,8 @@ struct SharedDma sSampleDmas[0x60];
 u32 gSampleDmaNumListItems; // sh: 0x803503D4
 u32 sSampleDmaListSize1; // sh: 0x803503D8
 u32 sUnused80226B40; // set to 0, never read, sh: 0x803503DC
+u32 sSampleDmaHits = 0; // only used for debugging, requests served from a DMA buffer
+u32 sSampleDmaMisses = 0; // only used for debugging, requests that started a new DMA
 
 // Circular buffer of DMAs with ttl = 0. tail <= head, wrapping around mod 256.
 u8 sSampleDmaReuseQueue1[256];
@@ -204,12 +206,19 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
     uintptr_t dmaDevAddr;
     u32 transfer;
     u32 i;
+    u32 count;
     u32 dmaIndex;
     ssize_t bufferPos;
     UNUSED u32 pad;
 
     if (arg2 != 0 || *dmaIndexRef >= sSampleDmaListSize1) {
-        for (i = sSampleDmaListSize1; i < gSampleDmaNumListItems; i++) {
+        // Start at the DMA this note used last; consecutive requests for a note
+        // usually fall in the same buffer, so the scan normally ends right away.
+        i = *dmaIndexRef;
+        if (i < sSampleDmaListSize1 || i >= gSampleDmaNumListItems) {
+            i = sSampleDmaListSize1;
+        }
+        for (count = sSampleDmaListSize1; count < gSampleDmaNumListItems; count++) {
 #if defined(VERSION_EU)
             dma = &sSampleDmas[i];
 #else
@@ -230,6 +239,7 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
                     sSampleDmaReuseQueueTail2++;
                 }
                 dma->ttl = 60;
+                sSampleDmaHits++;
                 *dmaIndexRef = (u8) i;
 #if defined(VERSION_EU)
                 return &dma->buffer[(devAddr - dma->source)];
@@ -237,6 +247,9 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
                 return (devAddr - dma->source) + dma->buffer;
 #endif
             }
+            if (++i == gSampleDmaNumListItems) {
+                i = sSampleDmaListSize1;
+            }
         }
 
         if (sSampleDmaReuseQueueTail2 != sSampleDmaReuseQueueHead2 && arg2 != 0) {
@@ -273,6 +286,7 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
                 sSampleDmaReuseQueueTail1++;
             }
             dma->ttl = 2;
+            sSampleDmaHits++;
 #if defined(VERSION_EU)
             return dma->buffer + (devAddr - dma->source);
 #else
@@ -289,6 +303,7 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef) {
         hasDma = TRUE;
     }
 
+    sSampleDmaMisses++;
     transfer = dma->bufSize;
     dmaDevAddr = devAddr & ~0xF;
     dma->ttl = 2;
@@ -75,6 +75,8 @@ struct SharedDma *sSampleDmas;
 u32 gSampleDmaNumListItems;
 u32 sSampleDmaListSize1;
 u32 sUnused80226B40; // set to 0, never read
+u32 sSampleDmaHits = 0; // only used for debugging, requests served from a DMA buffer
+u32 sSampleDmaMisses = 0; // only used for debugging, requests that started a new DMA
 
 // Circular buffer of DMAs with ttl = 0. tail <= head, wrapping around mod 256.
 u8 sSampleDmaReuseQueue1[256];
@@ -174,9 +176,16 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, s3
     u32 transfer;
     ssize_t bufferPos;
     u32 i;
+    u32 count;
 
     if (arg2 != 0 || *dmaIndexRef >= sSampleDmaListSize1) {
-        for (i = sSampleDmaListSize1; i < gSampleDmaNumListItems; i++) {
+        // Start at the DMA this note used last; consecutive requests for a note
+        // usually fall in the same buffer, so the scan normally ends right away.
+        i = *dmaIndexRef;
+        if (i < sSampleDmaListSize1 || i >= gSampleDmaNumListItems) {
+            i = sSampleDmaListSize1;
+        }
+        for (count = sSampleDmaListSize1; count < gSampleDmaNumListItems; count++) {
             dma = &sSampleDmas[i];
             bufferPos = devAddr - dma->source;
             if (0 <= bufferPos && (size_t) bufferPos <= dma->bufSize - size) {
@@ -193,9 +202,13 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, s3
                     sSampleDmaReuseQueueTail2++;
                 }
                 dma->ttl = 60;
+                sSampleDmaHits++;
                 *dmaIndexRef = (u8) i;
                 return &dma->buffer[(devAddr - dma->source)];
             }
+            if (++i == gSampleDmaNumListItems) {
+                i = sSampleDmaListSize1;
+            }
         }
 
         if (sSampleDmaReuseQueueTail2 != sSampleDmaReuseQueueHead2 && arg2 != 0) {
@@ -223,6 +236,7 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, s3
                 sSampleDmaReuseQueueTail1++;
             }
             dma->ttl = 2;
+            sSampleDmaHits++;
             return dma->buffer + (devAddr - dma->source);
         }
     }
@@ -236,6 +250,7 @@ void *dma_sample_data(uintptr_t devAddr, u32 size, s32 arg2, u8 *dmaIndexRef, s3
         hasDma = TRUE;
     }
 
+    sSampleDmaMisses++;
     transfer = dma->bufSize;
     dmaDevAddr = devAddr & ~0xF;
     dma->ttl = 2;
@@ -1095,17 +1095,23 @@ void audio_list_remove(struct AudioListItem *item) {
 }
 
 struct Note *pop_node_with_lower_prio(struct AudioListItem *list, s32 limit) {
-    struct AudioListItem *cur = list->next;
+    struct AudioListItem *cur = list->prev;
     struct AudioListItem *best;
 
     if (cur == list) {
         return NULL;
     }
 
-    for (best = cur; cur != list; cur = cur->next) {
-        if (((struct Note *) best->u.value)->priority >= ((struct Note *) cur->u.value)->priority) {
+    // Walk from the back so that ties resolve to the last lowest priority note,
+    // as a forward scan would, while allowing us to stop as soon as a note with
+    // the lowest possible priority is found.
+    for (best = cur; cur != list; cur = cur->prev) {
+        if (((struct Note *) best->u.value)->priority > ((struct Note *) cur->u.value)->priority) {
             best = cur;
         }
+        if (((struct Note *) best->u.value)->priority == NOTE_PRIORITY_DISABLED) {
+            break;
+        }
     }
 
 #if defined(VERSION_EU) || defined(VERSION_SH) || defined(VERSION_CN)
@@ -824,12 +824,14 @@ struct LevelCommand *level_script_execute(struct LevelCommand *cmd) {
     sScriptStatus = SCRIPT_RUNNING;
     sCurrentCmd = cmd;
 
+    PROFILER_ZONE_BEGIN(PROFILER_ZONE_LEVEL_SCRIPT);
     while (sScriptStatus == SCRIPT_RUNNING) {
         CN_DEBUG_PRINTF(("%08X: ", sCurrentCmd));
         CN_DEBUG_PRINTF(("%02d\n", sCurrentCmd->type));
 
         LevelScriptJumpTable[sCurrentCmd->type]();
     }
+    PROFILER_ZONE_END(PROFILER_ZONE_LEVEL_SCRIPT);
 
     profiler_log_thread5_time(LEVEL_SCRIPT_EXECUTE);
     init_rcp();
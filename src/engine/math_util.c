@@ -532,6 +532,32 @@ void mtxf_mul(Mat4 dest, Mat4 a, Mat4 b) {
     mtxf_copy(dest, temp);
 }
 
+/**
+ * Sets matrix 'dest' to the product of 'b' and a matrix that rotates by 'yaw'
+ * around the y axis and then translates by 'translate'. This is equivalent to
+ * building that matrix with mtxf_rotate_zxy_and_translate and calling
+ * mtxf_mul, but skips the terms that are zero when there is no pitch or roll.
+ * 'dest' must not be the same matrix as 'b'.
+ */
+void mtxf_rotate_y_translate_mul(Mat4 dest, Vec3f translate, s16 yaw, Mat4 b) {
+    register f32 sy = sins(yaw);
+    register f32 cy = coss(yaw);
+    register f32 tx = translate[0];
+    register f32 ty = translate[1];
+    register f32 tz = translate[2];
+    register s32 i;
+
+    for (i = 0; i < 3; i++) {
+        dest[0][i] = cy * b[0][i] - sy * b[2][i];
+        dest[1][i] = b[1][i];
+        dest[2][i] = sy * b[0][i] + cy * b[2][i];
+        dest[3][i] = tx * b[0][i] + ty * b[1][i] + tz * b[2][i] + b[3][i];
+    }
+
+    dest[0][3] = dest[1][3] = dest[2][3] = 0;
+    dest[3][3] = 1;
+}
+
 /**
  * Set matrix 'dest' to 'mtx' scaled by vector s
  */
@@ -395,10 +395,41 @@ f32 find_floor_height_and_data(f32 xPos, f32 yPos, f32 zPos, struct FloorGeometr
     return floorHeight;
 }
 
+/**
+ * Recent find_floor results. The floor found at an x and z stays the same for
+ * any y that still reaches it but none of the floors skipped before it in the
+ * cell lists, so a query repeated in that range, like the floor check under a
+ * shadow after an object's movement step, skips the list traversal. Entries
+ * expire whenever a surface partition changes.
+ */
+#define FLOOR_CACHE_SIZE 64
+#define FLOOR_CACHE_NO_LIMIT 1.0e30f
+
+struct FloorCacheEntry {
+    u32 generation;
+    s16 x;
+    s16 z;
+    // the result holds for y where y - minReach >= 0 and y - maxReach < 0,
+    // evaluated like the reach check in find_floor_from_list
+    f32 minReach;
+    f32 maxReach;
+    f32 height;
+    struct Surface *floor;
+    s8 missedStaticFloor;
+};
+
+static struct FloorCacheEntry sFloorCache[FLOOR_CACHE_SIZE];
+
+// Maximum number of points handled in a single pass by find_floor_heights
+#define FLOOR_BATCH_MAX 9
+
 /**
  * Iterate through the list of floors and find the first floor under a given point.
+ * If `reachLimit` is not NULL, it is lowered to the reach threshold of any floor
+ * skipped for being too high above the point.
  */
-static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32 x, s32 y, s32 z, f32 *pheight) {
+static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32 x, s32 y, s32 z, f32 *pheight,
+                                            f32 *reachLimit) {
     register struct Surface *surf;
     register s32 x1, z1, x2, z2, x3, z3;
     f32 nx, ny, nz;
@@ -457,6 +488,9 @@ static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32
         height = -(x * nx + nz * z + oo) / ny;
         // Checks for floor interaction with a 78 unit buffer.
         if (y - (height + -78.0f) < 0.0f) {
+            if (reachLimit != NULL && height + -78.0f < *reachLimit) {
+                *reachLimit = height + -78.0f;
+            }
             continue;
         }
 
@@ -470,6 +504,80 @@ static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32
     return floor;
 }
 
+/**
+ * Find the first floor under each of several points with the same y in one pass
+ * over the list. `floors` and `heights` receive the results for each point, as
+ * find_floor_from_list would give them.
+ */
+static void find_floors_from_list(struct SurfaceNode *surfaceNode, s32 count, TerrainData *x, s32 y,
+                                  TerrainData *z, struct Surface **floors, f32 *heights) {
+    register struct Surface *surf;
+    register s32 x1, z1, x2, z2, x3, z3;
+    f32 nx, ny, nz;
+    f32 oo;
+    f32 height;
+    s32 remaining = count;
+    s32 i;
+
+    for (i = 0; i < count; i++) {
+        floors[i] = NULL;
+    }
+
+    while (surfaceNode != NULL && remaining > 0) {
+        surf = surfaceNode->surface;
+        surfaceNode = surfaceNode->next;
+
+        if (gCheckingSurfaceCollisionsForCamera != 0) {
+            if (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION) {
+                continue;
+            }
+        } else if (surf->type == SURFACE_CAMERA_BOUNDARY) {
+            continue;
+        }
+
+        nx = surf->normal.x;
+        ny = surf->normal.y;
+        nz = surf->normal.z;
+        oo = surf->originOffset;
+
+        if (ny == 0.0f) {
+            continue;
+        }
+
+        x1 = surf->vertex1[0];
+        z1 = surf->vertex1[2];
+        x2 = surf->vertex2[0];
+        z2 = surf->vertex2[2];
+        x3 = surf->vertex3[0];
+        z3 = surf->vertex3[2];
+
+        for (i = 0; i < count; i++) {
+            if (floors[i] != NULL) {
+                continue;
+            }
+
+            if ((z1 - z[i]) * (x2 - x1) - (x1 - x[i]) * (z2 - z1) < 0) {
+                continue;
+            }
+            if ((z2 - z[i]) * (x3 - x2) - (x2 - x[i]) * (z3 - z2) < 0) {
+                continue;
+            }
+            if ((z3 - z[i]) * (x1 - x3) - (x3 - x[i]) * (z1 - z3) < 0) {
+                continue;
+            }
+
+            height = -(x[i] * nx + nz * z[i] + oo) / ny;
+            if (y - (height + -78.0f) < 0.0f) {
+                continue;
+            }
+
+            heights[i] = height;
+            floors[i] = surf;
+            remaining--;
+        }
+    }
+}
+
 /**
  * Find the height of the highest floor below a point.
  */
@@ -500,7 +608,7 @@ f32 unused_find_dynamic_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfl
     s16 cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
 
     surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
-    floor = find_floor_from_list(surfaceList, x, y, z, &floorHeight);
+    floor = find_floor_from_list(surfaceList, x, y, z, &floorHeight, NULL);
 
     *pfloor = floor;
 
@@ -515,9 +623,11 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
 
     struct Surface *floor, *dynamicFloor;
     struct SurfaceNode *surfaceList;
+    struct FloorCacheEntry *cacheEntry = NULL;
 
     f32 height = FLOOR_LOWER_LIMIT;
     f32 dynamicHeight = FLOOR_LOWER_LIMIT;
+    f32 reachLimit = FLOOR_CACHE_NO_LIMIT;
 
     //! (Parallel Universes) Because position is casted to an s16, reaching higher
     //  float locations can return floors despite them not existing there.
@@ -535,17 +645,47 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
         return height;
     }
 
+    // Reuse a recent result if the same floors are still the ones in reach.
+    if (!gFindFloorIncludeSurfaceIntangible && !gCheckingSurfaceCollisionsForCamera) {
+        cacheEntry = &sFloorCache[((x * 5) ^ (z * 3)) & (FLOOR_CACHE_SIZE - 1)];
+        if (cacheEntry->generation == gSurfaceGeneration && cacheEntry->x == x && cacheEntry->z == z
+            && !(y - cacheEntry->minReach < 0.0f) && y - cacheEntry->maxReach < 0.0f) {
+            if (cacheEntry->missedStaticFloor) {
+                gNumFindFloorMisses++;
+            }
+            *pfloor = cacheEntry->floor;
+            gNumCalls.floor++;
+            gNumCalls.floorCacheHits++;
+            return cacheEntry->height;
+        }
+    }
+
     // Each level is split into cells to limit load, find the appropriate cell.
     cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
     cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
 
     // Check for surfaces belonging to objects.
     surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
-    dynamicFloor = find_floor_from_list(surfaceList, x, y, z, &dynamicHeight);
+    dynamicFloor = find_floor_from_list(surfaceList, x, y, z, &dynamicHeight, &reachLimit);
 
     // Check for surfaces that are a part of level geometry.
     surfaceList = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
-    floor = find_floor_from_list(surfaceList, x, y, z, &height);
+    floor = find_floor_from_list(surfaceList, x, y, z, &height, &reachLimit);
+
+    if (cacheEntry != NULL) {
+        cacheEntry->generation = gSurfaceGeneration;
+        cacheEntry->x = x;
+        cacheEntry->z = z;
+        cacheEntry->minReach = -FLOOR_CACHE_NO_LIMIT;
+        cacheEntry->maxReach = reachLimit;
+        // both floors found must stay in reach
+        if (dynamicFloor != NULL) {
+            cacheEntry->minReach = dynamicHeight + -78.0f;
+        }
+        if (floor != NULL && height + -78.0f > cacheEntry->minReach) {
+            cacheEntry->minReach = height + -78.0f;
+        }
+    }
 
     // To prevent the Merry-Go-Round room from loading when Mario passes above the hole that leads
     // there, SURFACE_INTANGIBLE is used. This prevent the wrong room from loading, but can also allow
@@ -556,7 +696,12 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
         //  (happens when there is no floor under the SURFACE_INTANGIBLE floor) but returns the height
         //  of the SURFACE_INTANGIBLE floor instead of the typical -11000 returned for a NULL floor.
         if (floor != NULL && floor->type == SURFACE_INTANGIBLE) {
-            floor = find_floor_from_list(surfaceList, x, (s32)(height - 200.0f), z, &height);
+            floor = find_floor_from_list(surfaceList, x, (s32)(height - 200.0f), z, &height, NULL);
+            // the result depends on the intangible floor's height, so don't keep it
+            // (gSurfaceGeneration is never 0)
+            if (cacheEntry != NULL) {
+                cacheEntry->generation = 0;
+            }
         }
     } else {
         // To prevent accidentally leaving the floor tangible, stop checking for it.
@@ -568,6 +713,10 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
         gNumFindFloorMisses++;
     }
 
+    if (cacheEntry != NULL) {
+        cacheEntry->missedStaticFloor = floor == NULL;
+    }
+
     if (dynamicHeight > height) {
         floor = dynamicFloor;
         height = dynamicHeight;
@@ -575,12 +724,88 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
 
     *pfloor = floor;
 
+    if (cacheEntry != NULL) {
+        cacheEntry->floor = floor;
+        cacheEntry->height = height;
+    }
+
     // Increment the debug tracker.
     gNumCalls.floor++;
 
     return height;
 }
 
+/**
+ * Find the height of the floor under each of several points at the same y, with
+ * the same results as calling find_floor for each. Points that fall in one cell
+ * are checked in a single pass over that cell's floor lists.
+ */
+void find_floor_heights(f32 *xPos, f32 yPos, f32 *zPos, s32 count, f32 *heights) {
+    TerrainData x[FLOOR_BATCH_MAX];
+    TerrainData z[FLOOR_BATCH_MAX];
+    TerrainData y = (TerrainData) yPos;
+    struct Surface *floors[FLOOR_BATCH_MAX];
+    struct Surface *dynamicFloors[FLOOR_BATCH_MAX];
+    f32 dynamicHeights[FLOOR_BATCH_MAX];
+    struct SurfaceNode *surfaceList;
+    struct Surface *floor;
+    s16 cellX, cellZ;
+    s32 batched = count <= FLOOR_BATCH_MAX && !gFindFloorIncludeSurfaceIntangible;
+    s32 i;
+
+    for (i = 0; batched && i < count; i++) {
+        x[i] = (TerrainData) xPos[i];
+        z[i] = (TerrainData) zPos[i];
+
+        if (x[i] <= -LEVEL_BOUNDARY_MAX || x[i] >= LEVEL_BOUNDARY_MAX
+            || z[i] <= -LEVEL_BOUNDARY_MAX || z[i] >= LEVEL_BOUNDARY_MAX) {
+            batched = FALSE;
+        } else if (i == 0) {
+            cellX = ((x[i] + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+            cellZ = ((z[i] + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+        } else if (cellX != (((x[i] + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX)
+                   || cellZ != (((z[i] + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX)) {
+            batched = FALSE;
+        }
+    }
+
+    if (!batched) {
+        for (i = 0; i < count; i++) {
+            heights[i] = find_floor(xPos[i], yPos, zPos[i], &floor);
+        }
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        heights[i] = FLOOR_LOWER_LIMIT;
+        dynamicHeights[i] = FLOOR_LOWER_LIMIT;
+    }
+
+    surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
+    find_floors_from_list(surfaceList, count, x, y, z, dynamicFloors, dynamicHeights);
+
+    surfaceList = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
+    find_floors_from_list(surfaceList, count, x, y, z, floors, heights);
+
+    for (i = 0; i < count; i++) {
+        // See find_floor
+        if (floors[i] != NULL && floors[i]->type == SURFACE_INTANGIBLE) {
+            floors[i] = find_floor_from_list(surfaceList, x[i], (s32)(heights[i] - 200.0f), z[i],
+                                             &heights[i], NULL);
+        }
+
+        if (floors[i] == NULL) {
+            gNumFindFloorMisses++;
+        }
+
+        if (dynamicHeights[i] > heights[i]) {
+            heights[i] = dynamicHeights[i];
+        }
+
+        gNumCalls.floor++;
+    }
+}
+
 /**************************************************
  *               ENVIRONMENTAL BOXES              *
  **************************************************/
@@ -721,6 +946,7 @@ void debug_surface_list_info(f32 xPos, f32 zPos) {
     print_debug_top_down_mapinfo("%d", gNumCalls.floor);
     print_debug_top_down_mapinfo("%d", gNumCalls.wall);
     print_debug_top_down_mapinfo("%d", gNumCalls.ceil);
+    print_debug_top_down_mapinfo("%d", gNumCalls.floorCacheHits);
 
     set_text_array_x_y(-80, 0);
 
@@ -732,6 +958,7 @@ void debug_surface_list_info(f32 xPos, f32 zPos) {
     gNumCalls.floor = 0;
     gNumCalls.ceil = 0;
     gNumCalls.wall = 0;
+    gNumCalls.floorCacheHits = 0;
 }
 
 /**
@@ -35,6 +35,13 @@ s16 sSurfacePoolSize;
 
 u8 unused8038EEA8[0x30];
 
+/**
+ * Incremented whenever a partition changes, so cached collision results can
+ * tell whether they still hold. It is never 0, which marks a result that must
+ * not be reused.
+ */
+u32 gSurfaceGeneration = 1;
+
 /**
  * Allocate the part of the surface node pool to contain a surface node.
  */
@@ -73,12 +80,23 @@ static struct Surface *alloc_surface(void) {
     return surface;
 }
 
+/**
+ * Start a new surface generation, skipping 0 when the counter wraps around.
+ */
+static void advance_surface_generation(void) {
+    if (++gSurfaceGeneration == 0) {
+        gSurfaceGeneration = 1;
+    }
+}
+
 /**
  * Iterates through the entire partition, clearing the surfaces.
  */
 static void clear_spatial_partition(SpatialPartitionCell *cells) {
     register s32 i = NUM_CELLS * NUM_CELLS;
 
+    advance_surface_generation();
+
     while (i--) {
         (*cells)[SPATIAL_PARTITION_FLOORS].next = NULL;
         (*cells)[SPATIAL_PARTITION_CEILS].next = NULL;
@@ -110,6 +128,8 @@ static void add_surface_to_cell(s16 dynamic, s16 cellX, s16 cellZ, struct Surfac
     s16 sortDir;
     s16 listIndex;
 
+    advance_surface_generation();
+
     if (surface->normal.y > 0.01) {
         listIndex = SPATIAL_PARTITION_FLOORS;
         sortDir = 1; // highest to lowest, then insertion order
@@ -30,6 +30,7 @@ extern SpatialPartitionCell gDynamicSurfacePartition[NUM_CELLS][NUM_CELLS];
 extern struct SurfaceNode *sSurfaceNodePool;
 extern struct Surface *sSurfacePool;
 extern s16 sSurfacePoolSize;
+extern u32 gSurfaceGeneration;
 
 void alloc_surface_pools(void);
 #ifdef NO_SEGMENTED_MEMORY
@@ -13,6 +13,7 @@
 #include "mario.h"
 #include "mario_actions_cutscene.h"
 #include "print.h"
+#include "profiler.h"
 #include "hud.h"
 #include "audio/external.h"
 #include "area.h"
@@ -367,7 +368,9 @@ void play_transition_after_delay(s16 transType, s16 time, u8 red, u8 green, u8 b
 
 void render_game(void) {
     if (gCurrentArea != NULL && !gWarpTransition.pauseRendering) {
+        PROFILER_ZONE_BEGIN(PROFILER_ZONE_GRAPH);
         geo_process_root(gCurrentArea->unk04, D_8032CE74, D_8032CE78, gFBSetColor);
+        PROFILER_ZONE_END(PROFILER_ZONE_GRAPH);
 
         gSPViewport(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(&D_8032CF00));
 
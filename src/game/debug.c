@@ -282,6 +282,7 @@ void debug_unknown_level_select_check(void) {
         gNumCalls.floor = 0;
         gNumCalls.ceil = 0;
         gNumCalls.wall = 0;
+        gNumCalls.floorCacheHits = 0;
     }
 }
 
@@ -12,6 +12,7 @@
 #include "engine/behavior_script.h"
 #include "audio/external.h"
 #include "obj_behaviors.h"
+#include "profiler.h"
 
 /**
  * This file contains the function that handles 'environment effects',
@@ -37,6 +38,20 @@ Vec3i gSnowCylinderLastPos;
 s16 gSnowParticleCount;
 s16 gSnowParticleMaxCount;
 
+// Snow particle positions. Unlike bubbles, snowflakes need nothing but their
+// position, so these are kept as separate arrays in the allocation gEnvFxBuffer
+// points to, and the update loops only touch the coordinates.
+static s32 *sSnowParticleX;
+static s32 *sSnowParticleY;
+static s32 *sSnowParticleZ;
+
+// Number of snowflakes drawn per vertex load, limited by the microcode's vertex buffer
+#ifdef F3DEX_GBI_SHARED
+#define SNOWFLAKES_PER_BATCH 10
+#else
+#define SNOWFLAKES_PER_BATCH 5
+#endif
+
 /* DATA */
 s8 gEnvFxMode = ENVFX_MODE_NONE;
 UNUSED s32 D_80330644 = 0;
@@ -80,13 +95,16 @@ s32 envfx_init_snow(s32 mode) {
             break;
     }
 
-    gEnvFxBuffer = mem_pool_alloc(gEffectsMemoryPool,
-                                  gSnowParticleMaxCount * sizeof(struct EnvFxParticle));
+    gEnvFxBuffer = mem_pool_alloc(gEffectsMemoryPool, gSnowParticleMaxCount * 3 * sizeof(s32));
     if (gEnvFxBuffer == NULL) {
         return FALSE;
     }
 
-    bzero(gEnvFxBuffer, gSnowParticleMaxCount * sizeof(struct EnvFxParticle));
+    bzero(gEnvFxBuffer, gSnowParticleMaxCount * 3 * sizeof(s32));
+
+    sSnowParticleX = (s32 *) gEnvFxBuffer;
+    sSnowParticleY = sSnowParticleX + gSnowParticleMaxCount;
+    sSnowParticleZ = sSnowParticleY + gSnowParticleMaxCount;
 
     gEnvFxMode = mode;
     return TRUE;
@@ -174,21 +192,11 @@ void pos_from_orbit(Vec3s origin, Vec3s result, s16 radius, s16 pitch, s16 yaw)
  * 'view' is a cylinder of radius 300 and height 400 centered at the input
  * x, y and z.
  */
-s32 envfx_is_snowflake_alive(s32 index, s32 snowCylinderX, s32 snowCylinderY, s32 snowCylinderZ) {
-    s32 x = (gEnvFxBuffer + index)->xPos;
-    s32 y = (gEnvFxBuffer + index)->yPos;
-    s32 z = (gEnvFxBuffer + index)->zPos;
-
-    if (sqr(x - snowCylinderX) + sqr(z - snowCylinderZ) > sqr(300)) {
-        return FALSE;
-    }
-
-    if ((y < snowCylinderY - 201) || (snowCylinderY + 201 < y)) {
-        return FALSE;
-    }
-
-    return TRUE;
-}
+#define IS_SNOWFLAKE_ALIVE(index, snowCylinderX, snowCylinderY, snowCylinderZ)                       \
+    (sqr(sSnowParticleX[index] - (snowCylinderX)) + sqr(sSnowParticleZ[index] - (snowCylinderZ))   \
+         <= sqr(300)                                                                              \
+     && sSnowParticleY[index] >= (snowCylinderY) - 201                                            \
+     && sSnowParticleY[index] <= (snowCylinderY) + 201)
 
 /**
  * Update the position of each snowflake. Snowflakes wiggle by having a
@@ -209,21 +217,22 @@ void envfx_update_snow_normal(s32 snowCylinderX, s32 snowCylinderY, s32 snowCyli
     s32 deltaX = snowCylinderX - gSnowCylinderLastPos[0];
     s32 deltaY = snowCylinderY - gSnowCylinderLastPos[1];
     s32 deltaZ = snowCylinderZ - gSnowCylinderLastPos[2];
+    // the camera movement terms are the same for every flake
+    s16 respawnOffsetX = deltaX * 2;
+    s16 respawnOffsetZ = deltaZ * 2;
+    s16 driftX = deltaX / 1.2;
+    s16 fallY = 2 - (s16)(deltaY * 0.8);
+    s16 driftZ = deltaZ / 1.2;
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos =
-                400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
-            (gEnvFxBuffer + i)->zPos =
-                400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
-            (gEnvFxBuffer + i)->yPos = 200.0f * random_float() + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!IS_SNOWFLAKE_ALIVE(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            sSnowParticleX[i] = 400.0f * random_float() - 200.0f + snowCylinderX + respawnOffsetX;
+            sSnowParticleZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ + respawnOffsetZ;
+            sSnowParticleY[i] = 200.0f * random_float() + snowCylinderY;
         } else {
-            (gEnvFxBuffer + i)->xPos += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2);
-            (gEnvFxBuffer + i)->yPos -= 2 -(s16)(deltaY * 0.8);
-            (gEnvFxBuffer + i)->zPos += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
+            sSnowParticleX[i] += random_float() * 2 - 1.0f + driftX;
+            sSnowParticleY[i] -= fallY;
+            sSnowParticleZ[i] += random_float() * 2 - 1.0f + driftZ;
         }
     }
 
@@ -243,21 +252,21 @@ void envfx_update_snow_blizzard(s32 snowCylinderX, s32 snowCylinderY, s32 snowCy
     s32 deltaX = snowCylinderX - gSnowCylinderLastPos[0];
     s32 deltaY = snowCylinderY - gSnowCylinderLastPos[1];
     s32 deltaZ = snowCylinderZ - gSnowCylinderLastPos[2];
+    s16 respawnOffsetX = deltaX * 2;
+    s16 respawnOffsetZ = deltaZ * 2;
+    s16 driftX = deltaX / 1.2;
+    s16 fallY = 5 - (s16)(deltaY * 0.8);
+    s16 driftZ = deltaZ / 1.2;
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos =
-                400.0f * random_float() - 200.0f + snowCylinderX + (s16)(deltaX * 2);
-            (gEnvFxBuffer + i)->zPos =
-                400.0f * random_float() - 200.0f + snowCylinderZ + (s16)(deltaZ * 2);
-            (gEnvFxBuffer + i)->yPos = 400.0f * random_float() - 200.0f + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!IS_SNOWFLAKE_ALIVE(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            sSnowParticleX[i] = 400.0f * random_float() - 200.0f + snowCylinderX + respawnOffsetX;
+            sSnowParticleZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ + respawnOffsetZ;
+            sSnowParticleY[i] = 400.0f * random_float() - 200.0f + snowCylinderY;
         } else {
-            (gEnvFxBuffer + i)->xPos += random_float() * 2 - 1.0f + (s16)(deltaX / 1.2) + 20.0f;
-            (gEnvFxBuffer + i)->yPos -= 5 -(s16)(deltaY * 0.8);
-            (gEnvFxBuffer + i)->zPos += random_float() * 2 - 1.0f + (s16)(deltaZ / 1.2);
+            sSnowParticleX[i] += random_float() * 2 - 1.0f + driftX + 20.0f;
+            sSnowParticleY[i] -= fallY;
+            sSnowParticleZ[i] += random_float() * 2 - 1.0f + driftZ;
         }
     }
 
@@ -290,13 +299,10 @@ void envfx_update_snow_water(s32 snowCylinderX, s32 snowCylinderY, s32 snowCylin
     s32 i;
 
     for (i = 0; i < gSnowParticleCount; i++) {
-        (gEnvFxBuffer + i)->isAlive =
-            envfx_is_snowflake_alive(i, snowCylinderX, snowCylinderY, snowCylinderZ);
-        if (!(gEnvFxBuffer + i)->isAlive) {
-            (gEnvFxBuffer + i)->xPos = 400.0f * random_float() - 200.0f + snowCylinderX;
-            (gEnvFxBuffer + i)->zPos = 400.0f * random_float() - 200.0f + snowCylinderZ;
-            (gEnvFxBuffer + i)->yPos = 400.0f * random_float() - 200.0f + snowCylinderY;
-            (gEnvFxBuffer + i)->isAlive = TRUE;
+        if (!IS_SNOWFLAKE_ALIVE(i, snowCylinderX, snowCylinderY, snowCylinderZ)) {
+            sSnowParticleX[i] = 400.0f * random_float() - 200.0f + snowCylinderX;
+            sSnowParticleZ[i] = 400.0f * random_float() - 200.0f + snowCylinderZ;
+            sSnowParticleY[i] = 400.0f * random_float() - 200.0f + snowCylinderY;
         }
     }
 }
@@ -339,37 +345,31 @@ void rotate_triangle_vertices(Vec3s vertex1, Vec3s vertex2, Vec3s vertex3, s16 p
 }
 
 /**
- * Append 15 vertices to 'gfx', which is enough for 5 snowflakes starting at
- * 'index' in the buffer. The 3 input vertices represent the rotated triangle
- * around (0,0,0) that will be translated to snowflake positions to draw the
- * snowflake image.
+ * Write the vertices of the first 'count' snowflakes to 'vertBuf'.
+ * 'template' holds the snowflake triangle, already rotated to face the camera,
+ * which is translated to each snowflake's position.
  */
-void append_snowflake_vertex_buffer(Gfx *gfx, s32 index, Vec3s vertex1, Vec3s vertex2, Vec3s vertex3) {
-    s32 i = 0;
-    Vtx *vertBuf = (Vtx *) alloc_display_list(15 * sizeof(Vtx));
+void fill_snowflake_vertex_buffer(Vtx *vertBuf, s32 count, Vtx *template) {
+    s32 i;
 
-    if (vertBuf == NULL) {
-        return;
-    }
+    for (i = 0; i < count; i++) {
+        vertBuf[0] = template[0];
+        vertBuf[0].v.ob[0] += sSnowParticleX[i];
+        vertBuf[0].v.ob[1] += sSnowParticleY[i];
+        vertBuf[0].v.ob[2] += sSnowParticleZ[i];
 
-    for (i = 0; i < 15; i += 3) {
-        vertBuf[i] = gSnowTempVtx[0];
-        (vertBuf + i)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex1[0];
-        (vertBuf + i)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex1[1];
-        (vertBuf + i)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex1[2];
-
-        vertBuf[i + 1] = gSnowTempVtx[1];
-        (vertBuf + i + 1)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex2[0];
-        (vertBuf + i + 1)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex2[1];
-        (vertBuf + i + 1)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex2[2];
-
-        vertBuf[i + 2] = gSnowTempVtx[2];
-        (vertBuf + i + 2)->v.ob[0] = (gEnvFxBuffer + (index + i / 3))->xPos + vertex3[0];
-        (vertBuf + i + 2)->v.ob[1] = (gEnvFxBuffer + (index + i / 3))->yPos + vertex3[1];
-        (vertBuf + i + 2)->v.ob[2] = (gEnvFxBuffer + (index + i / 3))->zPos + vertex3[2];
-    }
+        vertBuf[1] = template[1];
+        vertBuf[1].v.ob[0] += sSnowParticleX[i];
+        vertBuf[1].v.ob[1] += sSnowParticleY[i];
+        vertBuf[1].v.ob[2] += sSnowParticleZ[i];
+
+        vertBuf[2] = template[2];
+        vertBuf[2].v.ob[0] += sSnowParticleX[i];
+        vertBuf[2].v.ob[1] += sSnowParticleY[i];
+        vertBuf[2].v.ob[2] += sSnowParticleZ[i];
 
-    gSPVertex(gfx, VIRTUAL_TO_PHYSICAL(vertBuf), 15, 0);
+        vertBuf += 3;
+    }
 }
 
 /**
@@ -377,10 +377,13 @@ void append_snowflake_vertex_buffer(Gfx *gfx, s32 index, Vec3s vertex1, Vec3s ve
  * drawing all snowflakes.
  */
 Gfx *envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo) {
-    s32 i;
+    s32 i, j;
+    s32 batchCount;
     s16 radius, pitch, yaw;
     Vec3s snowCylinderPos;
     struct SnowFlakeVertex vertex1, vertex2, vertex3;
+    Vtx template[3];
+    Vtx *vertBuf;
     Gfx *gfxStart;
     Gfx *gfx;
 
@@ -388,15 +391,20 @@ Gfx *envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo)
     vertex2 = gSnowFlakeVertex2;
     vertex3 = gSnowFlakeVertex3;
 
-    gfxStart = (Gfx *) alloc_display_list((gSnowParticleCount * 6 + 3) * sizeof(Gfx));
+    PROFILER_ZONE_BEGIN(PROFILER_ZONE_ENVFX);
+
+    envfx_update_snowflake_count(snowMode, marioPos);
+
+    // a vertex load and five triangle commands per batch
+    gfxStart = (Gfx *) alloc_display_list(
+        ((gSnowParticleCount + SNOWFLAKES_PER_BATCH - 1) / SNOWFLAKES_PER_BATCH * 6 + 3) * sizeof(Gfx));
     gfx = gfxStart;
 
     if (gfxStart == NULL) {
+        PROFILER_ZONE_END(PROFILER_ZONE_ENVFX);
         return NULL;
     }
 
-    envfx_update_snowflake_count(snowMode, marioPos);
-
     // Note: to and from are inverted here, so the resulting vector goes towards the camera
     orbit_from_positions(camTo, camFrom, &radius, &pitch, &yaw);
 
@@ -438,24 +446,56 @@ Gfx *envfx_update_snow(s32 snowMode, Vec3s marioPos, Vec3s camFrom, Vec3s camTo)
 
     rotate_triangle_vertices((s16 *) &vertex1, (s16 *) &vertex2, (s16 *) &vertex3, pitch, yaw);
 
+    template[0] = gSnowTempVtx[0];
+    template[0].v.ob[0] = vertex1.x;
+    template[0].v.ob[1] = vertex1.y;
+    template[0].v.ob[2] = vertex1.z;
+
+    template[1] = gSnowTempVtx[1];
+    template[1].v.ob[0] = vertex2.x;
+    template[1].v.ob[1] = vertex2.y;
+    template[1].v.ob[2] = vertex2.z;
+
+    template[2] = gSnowTempVtx[2];
+    template[2].v.ob[0] = vertex3.x;
+    template[2].v.ob[1] = vertex3.y;
+    template[2].v.ob[2] = vertex3.z;
+
     if (snowMode == ENVFX_SNOW_NORMAL || snowMode == ENVFX_SNOW_BLIZZARD) {
         gSPDisplayList(gfx++, &tiny_bubble_dl_0B006A50); // snowflake with gray edge
     } else if (snowMode == ENVFX_SNOW_WATER) {
         gSPDisplayList(gfx++, &tiny_bubble_dl_0B006CD8); // snowflake with blue edge
     }
 
-    for (i = 0; i < gSnowParticleCount; i += 5) {
-        append_snowflake_vertex_buffer(gfx++, i, (s16 *) &vertex1, (s16 *) &vertex2, (s16 *) &vertex3);
+    // the vertices of all snowflakes go in one buffer, loaded a batch at a time
+    vertBuf = (Vtx *) alloc_display_list(gSnowParticleCount * 3 * sizeof(Vtx));
+    if (vertBuf != NULL) {
+        fill_snowflake_vertex_buffer(vertBuf, gSnowParticleCount, template);
+
+        for (i = 0; i < gSnowParticleCount; i += SNOWFLAKES_PER_BATCH) {
+            batchCount = gSnowParticleCount - i;
+            if (batchCount > SNOWFLAKES_PER_BATCH) {
+                batchCount = SNOWFLAKES_PER_BATCH;
+            }
+
+            gSPVertex(gfx++, VIRTUAL_TO_PHYSICAL(vertBuf + i * 3), batchCount * 3, 0);
 
-        gSP1Triangle(gfx++, 0, 1, 2, 0);
-        gSP1Triangle(gfx++, 3, 4, 5, 0);
-        gSP1Triangle(gfx++, 6, 7, 8, 0);
-        gSP1Triangle(gfx++, 9, 10, 11, 0);
-        gSP1Triangle(gfx++, 12, 13, 14, 0);
+            for (j = 0; j < batchCount * 3; j += 3) {
+#ifdef F3DEX_GBI_SHARED
+                if (j + 3 < batchCount * 3) {
+                    gSP2Triangles(gfx++, j, j + 1, j + 2, 0, j + 3, j + 4, j + 5, 0);
+                    j += 3;
+                    continue;
+                }
+#endif
+                gSP1Triangle(gfx++, j, j + 1, j + 2, 0);
+            }
+        }
     }
 
     gSPDisplayList(gfx++, &tiny_bubble_dl_0B006AB0) gSPEndDisplayList(gfx++);
 
+    PROFILER_ZONE_END(PROFILER_ZONE_ENVFX);
     return gfxStart;
 }
 
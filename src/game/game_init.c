@@ -8,9 +8,12 @@
 #include "buffers/framebuffers.h"
 #include "buffers/zbuffer.h"
 #include "engine/level_script.h"
+#include "engine/surface_load.h"
 #include "game_init.h"
 #include "main.h"
 #include "memory.h"
+#include "level_update.h"
+#include "object_list_processor.h"
 #include "profiler.h"
 #include "save_file.h"
 #include "seq_ids.h"
@@ -62,6 +65,9 @@ static s32 sUnusedGameInitValue = 0;
 // General timer that runs as the game starts
 u32 gGlobalTimer = 0;
 
+// Lowest amount of free gfx pool space seen at the end of a frame
+static s32 sGfxPoolMinFree = GFX_POOL_SIZE * sizeof(Gfx);
+
 // Framebuffer rendering values (max 3)
 u16 sRenderedFramebuffer = 0;
 u16 sRenderingFramebuffer = 0;
@@ -365,6 +371,13 @@ void display_and_vsync(void) {
    // usb_write(DATATYPE_TEXT, &gMarioStates[0].pos[0], sizeof(gMarioStates[0].pos[0]));
 
     profiler_log_thread5_time(BEFORE_DISPLAY_LISTS);
+#if PIPELINE_GAME_LOOP
+    // The second vblank of the previous frame is waited for here rather than
+    // at the end of that frame, which let this frame's logic run while the RCP
+    // was still drawing the previous one. The pools alternate, so that task
+    // never reads the pool this frame was built in.
+    osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
+#endif
     osRecvMesg(&gGfxVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
     if (gGoddardVblankCallback != NULL) {
         gGoddardVblankCallback();
@@ -375,7 +388,9 @@ void display_and_vsync(void) {
     osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
     osViSwapBuffer((void *) PHYSICAL_TO_VIRTUAL(gPhysicalFramebuffers[sRenderedFramebuffer]));
     profiler_log_thread5_time(THREAD5_END);
+#if !PIPELINE_GAME_LOOP
     osRecvMesg(&gGameVblankQueue, &gMainReceivedMesg, OS_MESG_BLOCK);
+#endif
     if (++sRenderedFramebuffer == 3) {
         sRenderedFramebuffer = 0;
     }
@@ -422,6 +437,95 @@ UNUSED static void record_demo(void) {
     gRecordedDemoInput.timer++;
 }
 
+#if STATE_HASH
+// number of frames whose hash is kept, as a ring indexed by frame number
+#define STATE_HASH_LOG_SIZE 2048
+
+// Hashes of the game state after each frame of the current demo, read from a
+// RAM dump by tools/state_hashes.py. gStateHashFrames counts the frames hashed
+// since the demo started.
+u32 gStateHashLog[STATE_HASH_LOG_SIZE];
+u32 gStateHashFrames = 0;
+static struct DemoInput *sStateHashDemo = NULL;
+
+/**
+ * Return a value for a word of game state that doesn't depend on where the build
+ * placed things in memory. Pointers to objects and surfaces become their index
+ * in the pool, and any other pointer into RDRAM becomes just a tag. A value is
+ * taken to be a pointer if it is word aligned and in the first 8 MB of KSEG0, a
+ * range that floats and packed halfwords of game state very rarely fall in.
+ */
+static u32 state_hash_word(u32 word) {
+    u8 *ptr = (u8 *) word;
+
+    if ((word & 0xFF800003) != 0x80000000 || word == 0x80000000) {
+        return word;
+    }
+
+    if (ptr >= (u8 *) gObjectPool && ptr < (u8 *) &gObjectPool[OBJECT_POOL_CAPACITY]) {
+        return 0x4F000000 | (ptr - (u8 *) gObjectPool) / sizeof(struct Object);
+    }
+
+    if (sSurfacePool != NULL && ptr >= (u8 *) sSurfacePool
+        && ptr < (u8 *) &sSurfacePool[sSurfacePoolSize]) {
+        return 0x53000000 | (ptr - (u8 *) sSurfacePool) / sizeof(struct Surface);
+    }
+
+    return 0x50000000;
+}
+
+// FNV-1a over 32-bit words, with pointers replaced by state_hash_word
+static u32 hash_words(u32 hash, u32 *words, s32 count) {
+    s32 i;
+
+    for (i = 0; i < count; i++) {
+        hash = (hash ^ state_hash_word(words[i])) * 16777619U;
+    }
+
+    return hash;
+}
+
+/**
+ * Hash Mario's state and the fields of every loaded object, in object list
+ * order, and log it for this frame of the demo. The hash only covers values
+ * that stay the same across builds, so the logs of two builds can be compared.
+ */
+static void log_state_hash(void) {
+    u32 hash = 2166136261U;
+    struct ObjectNode *listHead;
+    struct Object *obj;
+    u32 word;
+    s32 i;
+
+    if (gCurrDemoInput == NULL) {
+        sStateHashDemo = NULL;
+        return;
+    }
+
+    // a new demo started
+    if (sStateHashDemo == NULL) {
+        sStateHashDemo = gCurrDemoInput;
+        gStateHashFrames = 0;
+    }
+
+    hash = hash_words(hash, (u32 *) &gMarioStates[0], sizeof(struct MarioState) / sizeof(u32));
+
+    for (i = 0; i < NUM_OBJ_LISTS; i++) {
+        listHead = &gObjectListArray[i];
+        for (obj = (struct Object *) listHead->next; obj != (struct Object *) listHead;
+             obj = (struct Object *) obj->header.next) {
+            // behaviors by their offset in the behavior segment
+            word = (u32) virtual_to_segmented(0x13, obj->behavior);
+            hash = (hash ^ word) * 16777619U;
+            hash = (hash ^ (u16) obj->activeFlags) * 16777619U;
+            hash = hash_words(hash, (u32 *) obj->rawData.asU32, 0x50);
+        }
+    }
+
+    gStateHashLog[gStateHashFrames++ % STATE_HASH_LOG_SIZE] = hash;
+}
+#endif
+
 /**
  * Take the updated controller struct and calculate the new x, y, and distance floats.
  */
@@ -675,6 +779,7 @@ void thread5_game_loop(UNUSED void *arg) {
     while (TRUE) {
         // If the reset timer is active, run the process to reset the game.
         if (gResetTimer != 0) {
+            save_file_flush_eeprom();
             draw_reset_bars();
             continue;
         }
@@ -693,14 +798,29 @@ void thread5_game_loop(UNUSED void *arg) {
         select_gfx_pool();
         read_controller_inputs();
         addr = level_script_execute(addr);
+#if STATE_HASH
+        log_state_hash();
+#endif
+        save_file_update_eeprom();
 
         display_and_vsync();
 
+        if (gGfxPoolEnd - (u8 *) gDisplayListHead < sGfxPoolMinFree) {
+            sGfxPoolMinFree = gGfxPoolEnd - (u8 *) gDisplayListHead;
+        }
+
         // when debug info is enabled, print the "BUF %d" information.
         if (gShowDebugText) {
+            struct MemoryPoolStats effectsPoolStats;
+
             // subtract the end of the gfx pool with the display list to obtain the
             // amount of free space remaining.
             print_text_fmt_int(180, 20, "BUF %d", gGfxPoolEnd - (u8 *) gDisplayListHead);
+            print_text_fmt_int(180, 52, "MIN %d", sGfxPoolMinFree);
+
+            // high-water mark of the effects pool
+            mem_pool_get_stats(gEffectsMemoryPool, &effectsPoolStats);
+            print_text_fmt_int(180, 84, "FXP %d", effectsPoolStats.peakUsedSpace);
         }
     }
 }
@@ -9,7 +9,11 @@
 #include "types.h"
 #include "memory.h"
 
+#ifndef GFX_POOL_SIZE
 #define GFX_POOL_SIZE 6400 // Size of how large the master display list (gDisplayListHead) can be
+#endif
+// Bytes of the gfx pool kept free for what is drawn after the scene graph (HUD, text)
+#define GFX_POOL_RESERVE 0x1000
 
 struct GfxPool {
     Gfx buffer[GFX_POOL_SIZE];
@@ -221,6 +221,62 @@ void create_dl_ortho_matrix(void) {
     gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(matrix), G_MTX_PROJECTION | G_MTX_MUL | G_MTX_NOPUSH)
 }
 
+#ifndef VERSION_US
+/**
+ * Glyphs decoded from the 1-bit font are cached between frames, keyed by the packed texture, so
+ * dialogs don't decode every character again each frame. The RCP may still be drawing the two
+ * previous frames, so only glyphs unused since then are replaced. If a set has none, the glyph is
+ * decoded into display list memory for this frame only.
+ */
+#define GLYPH_CACHE_SETS 32
+#define GLYPH_CACHE_WAYS 4
+#define GLYPH_CACHE_MIN_AGE 3
+#define GLYPH_CACHE_ENTRY_SIZE (8 * 16) // largest decoded glyph, 8x16 IA8
+
+struct GlyphCacheEntry {
+    void *packedTexture;
+    u32 lastUsed; // gGlobalTimer
+};
+
+static struct GlyphCacheEntry sGlyphCache[GLYPH_CACHE_SETS][GLYPH_CACHE_WAYS];
+ALIGNED8 static u8 sGlyphCacheData[GLYPH_CACHE_SETS][GLYPH_CACHE_WAYS][GLYPH_CACHE_ENTRY_SIZE];
+
+/**
+ * Find the decoded glyph for packedTexture. Sets *cached and returns it if it is in the cache,
+ * otherwise returns where to decode it to, or NULL if no cache entry can be replaced yet.
+ */
+static u8 *glyph_cache_get(void *packedTexture, s32 *cached) {
+    s32 setIndex = ((uintptr_t) packedTexture >> 4) & (GLYPH_CACHE_SETS - 1);
+    struct GlyphCacheEntry *set = sGlyphCache[setIndex];
+    s32 way;
+    s32 oldest = -1;
+
+    *cached = FALSE;
+
+    for (way = 0; way < GLYPH_CACHE_WAYS; way++) {
+        if (set[way].packedTexture == packedTexture) {
+            *cached = TRUE;
+            oldest = way;
+            break;
+        }
+
+        if (set[way].packedTexture == NULL || gGlobalTimer - set[way].lastUsed >= GLYPH_CACHE_MIN_AGE) {
+            if (oldest < 0 || set[way].lastUsed < set[oldest].lastUsed) {
+                oldest = way;
+            }
+        }
+    }
+
+    if (oldest < 0) {
+        return NULL;
+    }
+
+    set[oldest].packedTexture = packedTexture;
+    set[oldest].lastUsed = gGlobalTimer;
+    return sGlyphCacheData[setIndex][oldest];
+}
+#endif
+
 #if defined(VERSION_US) || defined(VERSION_EU)
 UNUSED
 #endif
@@ -229,8 +285,15 @@ static u8 *alloc_ia8_text_from_i1(u8 *in) {
     s32 i, j;
     u8 l, r;
     u8 bitMask = 0x80;
-    u8 *out = alloc_display_list(8 * 8);
+    s32 cached;
+    u8 *out = glyph_cache_get(in, &cached);
 
+    if (cached) {
+        return out;
+    }
+    if (out == NULL) {
+        out = alloc_display_list(8 * 8);
+    }
     if (out == NULL) {
         return NULL;
     }
@@ -256,8 +319,19 @@ static u8 *alloc_ia8_text_from_i1(u16 *in, s16 width, s16 height) {
     u16 bitMask;
     u8 *out;
     s16 outPos = 0;
+#ifndef VERSION_US
+    s32 cached;
 
+    out = glyph_cache_get(in, &cached);
+    if (cached) {
+        return out;
+    }
+    if (out == NULL) {
+        out = (u8 *) alloc_display_list((u32) width * (u32) height);
+    }
+#else
     out = (u8 *) alloc_display_list((u32) width * (u32) height);
+#endif
 
     if (out == NULL) {
         return NULL;
@@ -316,8 +390,15 @@ u8 *alloc_ia4_tex_from_i1(u8 *in, s16 width, s16 height) {
     s32 inPos;
     s16 outPos = 0;
     u8 bitMask;
+    s32 cached;
 
-    out = (u8 *) alloc_display_list(size);
+    out = glyph_cache_get(in, &cached);
+    if (cached) {
+        return out;
+    }
+    if (out == NULL) {
+        out = (u8 *) alloc_display_list(size);
+    }
 
     if (out == NULL) {
         return NULL;
@@ -30,15 +30,32 @@ struct MainPoolBlock {
     struct MainPoolBlock *next;
 };
 
+// Memory pools are segregated-fit allocators: free blocks are kept on one
+// doubly linked list per power of two size class, and a bit per class tracks
+// which lists are non-empty. Each block records its own size and the size of
+// the block before it, so freeing merges with both neighbors in constant time.
+#define MEMORY_POOL_NUM_BINS 16
+#define MEMORY_BLOCK_FREE 1
+#define MEMORY_BLOCK_SIZE(block) ((block)->size & ~MEMORY_BLOCK_FREE)
+
 struct MemoryBlock {
-    struct MemoryBlock *next;
-    u32 size;
+    u32 size; // including this header, MEMORY_BLOCK_FREE is set while free
+    u32 prevSize; // size of the block just before this one, 0 for the first
+};
+
+struct MemoryFreeBlock {
+    struct MemoryBlock header;
+    struct MemoryFreeBlock *next;
+    struct MemoryFreeBlock *prev;
 };
 
 struct MemoryPool {
     u32 totalSpace;
-    struct MemoryBlock *firstBlock;
-    struct MemoryBlock freeList;
+    u32 usedSpace;
+    u32 peakUsedSpace;
+    u32 binMask;
+    u8 *end;
+    struct MemoryFreeBlock *bins[MEMORY_POOL_NUM_BINS];
 };
 
 // Double declared to preserve US bss ordering.
@@ -433,6 +450,55 @@ struct AllocOnlyPool *alloc_only_pool_resize(struct AllocOnlyPool *pool, u32 siz
     return newPool;
 }
 
+/**
+ * Return the size class of a block: bin 0 holds blocks of 16 to 31 bytes, bin
+ * 1 blocks of 32 to 63 bytes, and so on, with everything larger in the last.
+ */
+static s32 mem_pool_bin(u32 size) {
+    s32 bin = 0;
+
+    size >>= 5;
+    while (size != 0 && bin < MEMORY_POOL_NUM_BINS - 1) {
+        size >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+static void mem_pool_insert_free(struct MemoryPool *pool, struct MemoryFreeBlock *block, u32 size) {
+    s32 bin = mem_pool_bin(size);
+
+    block->header.size = size | MEMORY_BLOCK_FREE;
+    block->prev = NULL;
+    block->next = pool->bins[bin];
+    if (block->next != NULL) {
+        block->next->prev = block;
+    }
+
+    pool->bins[bin] = block;
+    pool->binMask |= 1 << bin;
+}
+
+static void mem_pool_remove_free(struct MemoryPool *pool, struct MemoryFreeBlock *block) {
+    s32 bin = mem_pool_bin(MEMORY_BLOCK_SIZE(&block->header));
+
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        pool->bins[bin] = block->next;
+        if (block->next == NULL) {
+            pool->binMask &= ~(1 << bin);
+        }
+    }
+
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+
+    block->header.size &= ~MEMORY_BLOCK_FREE;
+}
+
 /**
  * Allocate a memory pool from the main pool. This pool supports arbitrary
  * order for allocation/freeing.
@@ -440,8 +506,9 @@ struct AllocOnlyPool *alloc_only_pool_resize(struct AllocOnlyPool *pool, u32 siz
  */
 struct MemoryPool *mem_pool_init(u32 size, u32 side) {
     void *addr;
-    struct MemoryBlock *block;
+    struct MemoryFreeBlock *block;
     struct MemoryPool *pool = NULL;
+    s32 i;
 
     size = ALIGN4(size);
     addr = main_pool_alloc(size + sizeof(struct MemoryPool), side);
@@ -449,12 +516,17 @@ struct MemoryPool *mem_pool_init(u32 size, u32 side) {
         pool = (struct MemoryPool *) addr;
 
         pool->totalSpace = size;
-        pool->firstBlock = (struct MemoryBlock *) ((u8 *) addr + sizeof(struct MemoryPool));
-        pool->freeList.next = (struct MemoryBlock *) ((u8 *) addr + sizeof(struct MemoryPool));
+        pool->usedSpace = 0;
+        pool->peakUsedSpace = 0;
+        pool->binMask = 0;
+        pool->end = (u8 *) addr + sizeof(struct MemoryPool) + size;
+        for (i = 0; i < MEMORY_POOL_NUM_BINS; i++) {
+            pool->bins[i] = NULL;
+        }
 
-        block = pool->firstBlock;
-        block->next = NULL;
-        block->size = pool->totalSpace;
+        block = (struct MemoryFreeBlock *) ((u8 *) addr + sizeof(struct MemoryPool));
+        block->header.prevSize = 0;
+        mem_pool_insert_free(pool, block, size);
     }
     return pool;
 }
@@ -463,73 +535,119 @@ struct MemoryPool *mem_pool_init(u32 size, u32 side) {
  * Allocate from a memory pool. Return NULL if there is not enough space.
  */
 void *mem_pool_alloc(struct MemoryPool *pool, u32 size) {
-    struct MemoryBlock *freeBlock = &pool->freeList;
-    void *addr = NULL;
+    struct MemoryFreeBlock *block;
+    struct MemoryBlock *next;
+    u32 blockSize;
+    s32 bin;
 
     size = ALIGN4(size) + sizeof(struct MemoryBlock);
-    while (freeBlock->next != NULL) {
-        if (freeBlock->next->size >= size) {
-            addr = (u8 *) freeBlock->next + sizeof(struct MemoryBlock);
-            if (freeBlock->next->size - size <= sizeof(struct MemoryBlock)) {
-                freeBlock->next = freeBlock->next->next;
-            } else {
-                struct MemoryBlock *newBlock = (struct MemoryBlock *) ((u8 *) freeBlock->next + size);
-                newBlock->size = freeBlock->next->size - size;
-                newBlock->next = freeBlock->next->next;
-                freeBlock->next->size = size;
-                freeBlock->next = newBlock;
-            }
-            break;
+    if (size < sizeof(struct MemoryFreeBlock)) {
+        size = sizeof(struct MemoryFreeBlock);
+    }
+
+    // Blocks in the size's own class may still be too small, but any block in
+    // a larger class fits
+    bin = mem_pool_bin(size);
+    block = pool->bins[bin];
+    while (block != NULL && MEMORY_BLOCK_SIZE(&block->header) < size) {
+        block = block->next;
+    }
+
+    if (block == NULL) {
+        if ((pool->binMask >> (bin + 1)) == 0) {
+            return NULL;
         }
-        freeBlock = freeBlock->next;
+
+        do {
+            bin++;
+        } while (!(pool->binMask & (1 << bin)));
+        block = pool->bins[bin];
     }
-    return addr;
+
+    mem_pool_remove_free(pool, block);
+    blockSize = block->header.size;
+
+    // Split off the rest if it's big enough to be a block of its own
+    if (blockSize - size >= sizeof(struct MemoryFreeBlock)) {
+        struct MemoryFreeBlock *rest = (struct MemoryFreeBlock *) ((u8 *) block + size);
+
+        rest->header.prevSize = size;
+        mem_pool_insert_free(pool, rest, blockSize - size);
+
+        next = (struct MemoryBlock *) ((u8 *) block + blockSize);
+        if ((u8 *) next < pool->end) {
+            next->prevSize = blockSize - size;
+        }
+
+        block->header.size = blockSize = size;
+    }
+
+    pool->usedSpace += blockSize;
+    if (pool->usedSpace > pool->peakUsedSpace) {
+        pool->peakUsedSpace = pool->usedSpace;
+    }
+
+    return (u8 *) block + sizeof(struct MemoryBlock);
 }
 
 /**
  * Free a block that was allocated using mem_pool_alloc.
  */
 BAD_RETURN(s32) mem_pool_free(struct MemoryPool *pool, void *addr) {
-    struct MemoryBlock *block = (struct MemoryBlock *) ((u8 *) addr - sizeof(struct MemoryBlock));
-    struct MemoryBlock *freeList = pool->freeList.next;
+    struct MemoryFreeBlock *block = (struct MemoryFreeBlock *) ((u8 *) addr - sizeof(struct MemoryBlock));
+    struct MemoryFreeBlock *neighbor;
+    struct MemoryBlock *next;
+    u32 size = block->header.size;
 
-    if (pool->freeList.next == NULL) {
-        pool->freeList.next = block;
-        block->next = NULL;
-    } else {
-        if (block < pool->freeList.next) {
-            if ((u8 *) pool->freeList.next == (u8 *) block + block->size) {
-                block->size += freeList->size;
-                block->next = freeList->next;
-                pool->freeList.next = block;
-            } else {
-                block->next = pool->freeList.next;
-                pool->freeList.next = block;
-            }
-        } else {
-            while (freeList->next != NULL) {
-                if (freeList < block && block < freeList->next) {
-                    break;
-                }
+    pool->usedSpace -= size;
 
-                freeList = freeList->next;
-            }
+    // Merge with the following block if it is free
+    neighbor = (struct MemoryFreeBlock *) ((u8 *) block + size);
+    if ((u8 *) neighbor < pool->end && (neighbor->header.size & MEMORY_BLOCK_FREE)) {
+        mem_pool_remove_free(pool, neighbor);
+        size += neighbor->header.size;
+    }
 
-            if (block == (struct MemoryBlock *) ((u8 *) freeList + freeList->size)) {
-                freeList->size += block->size;
-                block = freeList;
-            } else {
-                block->next = freeList->next;
-                freeList->next = block;
-            }
+    // And with the preceding one
+    if (block->header.prevSize != 0) {
+        neighbor = (struct MemoryFreeBlock *) ((u8 *) block - block->header.prevSize);
+        if (neighbor->header.size & MEMORY_BLOCK_FREE) {
+            mem_pool_remove_free(pool, neighbor);
+            size += neighbor->header.size;
+            block = neighbor;
+        }
+    }
 
-            if (block->next != NULL && (u8 *) block->next == (u8 *) block + block->size) {
-                block->size = block->size + block->next->size;
-                block->next = block->next->next;
+    next = (struct MemoryBlock *) ((u8 *) block + size);
+    if ((u8 *) next < pool->end) {
+        next->prevSize = size;
+    }
+
+    mem_pool_insert_free(pool, block, size);
+    // nothing is returned, but must have non-void return type for render_text_labels to match on iQue
+}
+
+/**
+ * Fill in usage and fragmentation statistics for a memory pool.
+ */
+void mem_pool_get_stats(struct MemoryPool *pool, struct MemoryPoolStats *stats) {
+    struct MemoryFreeBlock *block;
+    s32 bin;
+
+    stats->totalSpace = pool->totalSpace;
+    stats->usedSpace = pool->usedSpace;
+    stats->peakUsedSpace = pool->peakUsedSpace;
+    stats->largestFreeBlock = 0;
+    stats->numFreeBlocks = 0;
+
+    for (bin = 0; bin < MEMORY_POOL_NUM_BINS; bin++) {
+        for (block = pool->bins[bin]; block != NULL; block = block->next) {
+            if (MEMORY_BLOCK_SIZE(&block->header) > stats->largestFreeBlock) {
+                stats->largestFreeBlock = MEMORY_BLOCK_SIZE(&block->header);
             }
+            stats->numFreeBlocks++;
         }
     }
-    // nothing is returned, but must have non-void return type for render_text_labels to match on iQue
 }
 
 void *alloc_display_list(u32 size) {
@@ -17,6 +17,14 @@ struct AllocOnlyPool {
 
 struct MemoryPool;
 
+struct MemoryPoolStats {
+    u32 totalSpace;
+    u32 usedSpace; // including block headers
+    u32 peakUsedSpace;
+    u32 largestFreeBlock;
+    u32 numFreeBlocks;
+};
+
 struct OffsetSizePair {
     u32 offset;
     u32 size;
@@ -76,6 +84,7 @@ struct AllocOnlyPool *alloc_only_pool_resize(struct AllocOnlyPool *pool, u32 siz
 struct MemoryPool *mem_pool_init(u32 size, u32 side);
 void *mem_pool_alloc(struct MemoryPool *pool, u32 size);
 BAD_RETURN(s32) mem_pool_free(struct MemoryPool *pool, void *addr);
+void mem_pool_get_stats(struct MemoryPool *pool, struct MemoryPoolStats *stats);
 
 void *alloc_display_list(u32 size);
 void setup_dma_table_list(struct DmaHandlerList *list, void *srcAddr, void *buffer);
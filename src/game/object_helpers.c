@@ -840,25 +840,22 @@ f32 cur_obj_dist_to_nearest_object_with_behavior(const BehaviorScript *behavior)
 
 struct Object *cur_obj_find_nearest_object_with_behavior(const BehaviorScript *behavior, f32 *dist) {
     uintptr_t *behaviorAddr = segmented_to_virtual(behavior);
+    u32 objList = get_object_list_from_behavior(behaviorAddr);
     struct Object *closestObj = NULL;
     struct Object *obj;
-    struct ObjectNode *listHead;
     f32 minDist = 0x20000;
 
-    listHead = &gObjectLists[get_object_list_from_behavior(behaviorAddr)];
-    obj = (struct Object *) listHead->next;
+    obj = find_first_object_with_behavior(behaviorAddr, objList);
 
-    while (obj != (struct Object *) listHead) {
-        if (obj->behavior == behaviorAddr) {
-            if (obj->activeFlags != ACTIVE_FLAG_DEACTIVATED && obj != o) {
-                f32 objDist = dist_between_objects(o, obj);
-                if (objDist < minDist) {
-                    closestObj = obj;
-                    minDist = objDist;
-                }
+    while (obj != NULL) {
+        if (obj->activeFlags != ACTIVE_FLAG_DEACTIVATED && obj != o) {
+            f32 objDist = dist_between_objects(o, obj);
+            if (objDist < minDist) {
+                closestObj = obj;
+                minDist = objDist;
             }
         }
-        obj = (struct Object *) obj->header.next;
+        obj = find_next_object_with_behavior(obj, objList);
     }
 
     *dist = minDist;
@@ -891,16 +888,13 @@ s32 count_unimportant_objects(void) {
 
 s32 count_objects_with_behavior(const BehaviorScript *behavior) {
     uintptr_t *behaviorAddr = segmented_to_virtual(behavior);
-    struct ObjectNode *listHead = &gObjectLists[get_object_list_from_behavior(behaviorAddr)];
-    struct ObjectNode *obj = listHead->next;
+    u32 objList = get_object_list_from_behavior(behaviorAddr);
+    struct Object *obj = find_first_object_with_behavior(behaviorAddr, objList);
     s32 count = 0;
 
-    while (listHead != obj) {
-        if (((struct Object *) obj)->behavior == behaviorAddr) {
-            count++;
-        }
-
-        obj = obj->next;
+    while (obj != NULL) {
+        count++;
+        obj = find_next_object_with_behavior(obj, objList);
     }
 
     return count;
@@ -908,25 +902,22 @@ s32 count_objects_with_behavior(const BehaviorScript *behavior) {
 
 struct Object *cur_obj_find_nearby_held_actor(const BehaviorScript *behavior, f32 maxDist) {
     const BehaviorScript *behaviorAddr = segmented_to_virtual(behavior);
-    struct ObjectNode *listHead = &gObjectLists[OBJ_LIST_GENACTOR];
-    struct Object *obj = (struct Object *) listHead->next;
+    struct Object *obj = find_first_object_with_behavior(behaviorAddr, OBJ_LIST_GENACTOR);
     struct Object *foundObj = NULL;
 
-    while ((struct Object *) listHead != obj) {
-        if (obj->behavior == behaviorAddr) {
-            if (obj->activeFlags != ACTIVE_FLAG_DEACTIVATED) {
-                // This includes the dropped and thrown states. By combining instant
-                // release, this allows us to activate mama penguin remotely
-                if (obj->oHeldState != HELD_FREE) {
-                    if (dist_between_objects(o, obj) < maxDist) {
-                        foundObj = obj;
-                        break;
-                    }
+    while (obj != NULL) {
+        if (obj->activeFlags != ACTIVE_FLAG_DEACTIVATED) {
+            // This includes the dropped and thrown states. By combining instant
+            // release, this allows us to activate mama penguin remotely
+            if (obj->oHeldState != HELD_FREE) {
+                if (dist_between_objects(o, obj) < maxDist) {
+                    foundObj = obj;
+                    break;
                 }
             }
         }
 
-        obj = (struct Object *) obj->header.next;
+        obj = find_next_object_with_behavior(obj, OBJ_LIST_GENACTOR);
     }
 
     return foundObj;
@@ -1458,11 +1449,11 @@ s32 obj_check_if_collided_with_object(struct Object *obj1, struct Object *obj2)
 }
 
 void cur_obj_set_behavior(const BehaviorScript *behavior) {
-    o->behavior = segmented_to_virtual(behavior);
+    set_object_behavior(o, segmented_to_virtual(behavior));
 }
 
 void obj_set_behavior(struct Object *obj, const BehaviorScript *behavior) {
-    obj->behavior = segmented_to_virtual(behavior);
+    set_object_behavior(obj, segmented_to_virtual(behavior));
 }
 
 s32 cur_obj_has_behavior(const BehaviorScript *behavior) {
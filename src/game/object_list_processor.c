@@ -1,4 +1,5 @@
 #include <PR/ultratypes.h>
+#include <PR/os_misc.h>
 
 #include "sm64.h"
 #include "area.h"
@@ -11,6 +12,7 @@
 #include "engine/surface_load.h"
 #include "interaction.h"
 #include "level_update.h"
+#include "main.h"
 #include "mario.h"
 #include "memory.h"
 #include "object_collision.h"
@@ -292,12 +294,21 @@ void bhv_mario_update(void) {
  */
 s32 update_objects_starting_at(struct ObjectNode *objList, struct ObjectNode *firstObj) {
     s32 count = 0;
+#if PROFILER_BEHAVIORS
+    u32 startCycles;
+#endif
 
     while (objList != firstObj) {
         gCurrentObject = (struct Object *) firstObj;
 
         gCurrentObject->header.gfx.node.flags |= GRAPH_RENDER_HAS_ANIMATION;
+#if PROFILER_BEHAVIORS
+        startCycles = osGetCount();
+        cur_obj_update();
+        profiler_log_behavior(gCurrentObject->behavior, osGetCount() - startCycles);
+#else
         cur_obj_update();
+#endif
 
         firstObj = firstObj->next;
         count++;
@@ -626,6 +637,7 @@ UNUSED static u16 unused_get_elapsed_time(u64 *cycleCounts, s32 index) {
 void update_objects(UNUSED s32 unused) {
     s64 cycleCounts[30];
 
+    PROFILER_ZONE_BEGIN(PROFILER_ZONE_OBJECTS);
     cycleCounts[0] = get_current_clock();
 
     gTimeStopState &= ~TIME_STOP_MARIO_OPENED_DOOR;
@@ -655,7 +667,9 @@ void update_objects(UNUSED s32 unused) {
 
     // Detect which objects are intersecting
     cycleCounts[3] = get_clock_difference(cycleCounts[0]);
+    PROFILER_ZONE_BEGIN(PROFILER_ZONE_OBJECT_COLLISION);
     detect_object_collisions();
+    PROFILER_ZONE_END(PROFILER_ZONE_OBJECT_COLLISION);
 
     // Update all other objects that haven't been updated yet
     cycleCounts[4] = get_clock_difference(cycleCounts[0]);
@@ -683,4 +697,11 @@ void update_objects(UNUSED s32 unused) {
     }
 
     gPrevFrameObjectCount = gObjectCounter;
+#if PROFILER_BEHAVIORS
+    profiler_end_behavior_frame();
+    if (gShowProfiler) {
+        profiler_print_behavior_stats();
+    }
+#endif
+    PROFILER_ZONE_END(PROFILER_ZONE_OBJECTS);
 }
@@ -70,6 +70,7 @@ struct NumTimesCalled {
     /*0x00*/ s16 floor;
     /*0x02*/ s16 ceil;
     /*0x04*/ s16 wall;
+    /*0x06*/ s16 floorCacheHits;
 };
 
 extern struct NumTimesCalled gNumCalls;
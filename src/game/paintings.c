@@ -142,17 +142,39 @@ f32 gPaintingMarioYPos;
 f32 gPaintingMarioZPos;
 
 /**
- * When a painting is rippling, this mesh is generated each frame using the Painting's parameters.
+ * Size of seg2_painting_triangle_mesh, which all paintings ripple with.
+ */
+#define PAINTING_MESH_NUM_VERTICES 157
+#define PAINTING_MESH_NUM_TRIS 264
+
+static struct PaintingMeshVertex sPaintingMesh[PAINTING_MESH_NUM_VERTICES];
+static Vec3f sPaintingTriNorms[PAINTING_MESH_NUM_TRIS];
+
+/**
+ * Which vertices moved and which triangle normals changed since the mesh was last generated, so
+ * that only the normals depending on them are recomputed.
+ */
+static u8 sPaintingVertexMoved[PAINTING_MESH_NUM_VERTICES];
+static u8 sPaintingTriNormChanged[PAINTING_MESH_NUM_TRIS];
+
+/**
+ * The painting the mesh was last generated for, and the ripple parameters it was generated with.
+ */
+static struct Painting *sPaintingMeshOwner = NULL;
+static f32 sPaintingMeshRipple[7];
+
+/**
+ * When a painting is rippling, this mesh is updated each frame using the Painting's parameters.
  *
  * This mesh only contains the vertex positions and normals.
  * Paintings use an additional array to map textures to the mesh.
  */
-struct PaintingMeshVertex *gPaintingMesh;
+struct PaintingMeshVertex *gPaintingMesh = sPaintingMesh;
 
 /**
  * The painting's surface normals, used to approximate each of the vertex normals (for gouraud shading).
  */
-Vec3f *gPaintingTriNorms;
+Vec3f *gPaintingTriNorms = sPaintingTriNorms;
 
 /**
  * The painting that is currently rippling. Only one painting can be rippling at once.
@@ -663,8 +685,8 @@ s16 ripple_if_movable(struct Painting *painting, s16 movable, s16 posX, s16 posY
 }
 
 /**
- * Allocates and generates a mesh for the rippling painting effect by modifying the passed in `mesh`
- * based on the painting's current ripple state.
+ * Updates the mesh for the rippling painting effect by modifying the passed in `mesh` based on the
+ * painting's current ripple state.
  *
  * The `mesh` table describes the location of mesh vertices, whether they move when rippling, and what
  * triangles they belong to.
@@ -680,21 +702,39 @@ s16 ripple_if_movable(struct Painting *painting, s16 movable, s16 posX, s16 posY
  *      Where x and y are from 0 to PAINTING_SIZE, movable is 0 or 1.
  *
  * The mesh used in game, seg2_painting_triangle_mesh, is in bin/segment2.c.
+ *
+ * If the mesh was last generated for this painting, only the movable vertices are updated, and
+ * the ones whose position changed are flagged in sPaintingVertexMoved.
  */
 void painting_generate_mesh(struct Painting *painting, s16 *mesh, s16 numTris) {
     s16 i;
-
-    gPaintingMesh = mem_pool_alloc(gEffectsMemoryPool, numTris * sizeof(struct PaintingMeshVertex));
-    if (gPaintingMesh == NULL) {
+    s16 rippleZ;
+
+    if (sPaintingMeshOwner != painting) {
+        sPaintingMeshOwner = painting;
+
+        // accesses are off by 1 since the first entry is the number of vertices
+        for (i = 0; i < numTris; i++) {
+            gPaintingMesh[i].pos[0] = mesh[i * 3 + 1];
+            gPaintingMesh[i].pos[1] = mesh[i * 3 + 2];
+            // The "z coordinate" of each vertex in the mesh is either 1 or 0. Instead of being an
+            // actual coordinate, it just determines whether the vertex moves
+            gPaintingMesh[i].pos[2] = ripple_if_movable(painting, mesh[i * 3 + 3],
+                                                        gPaintingMesh[i].pos[0], gPaintingMesh[i].pos[1]);
+            sPaintingVertexMoved[i] = TRUE;
+        }
+        return;
     }
-    // accesses are off by 1 since the first entry is the number of vertices
+
     for (i = 0; i < numTris; i++) {
-        gPaintingMesh[i].pos[0] = mesh[i * 3 + 1];
-        gPaintingMesh[i].pos[1] = mesh[i * 3 + 2];
-        // The "z coordinate" of each vertex in the mesh is either 1 or 0. Instead of being an
-        // actual coordinate, it just determines whether the vertex moves
-        gPaintingMesh[i].pos[2] = ripple_if_movable(painting, mesh[i * 3 + 3],
-                                                    gPaintingMesh[i].pos[0], gPaintingMesh[i].pos[1]);
+        sPaintingVertexMoved[i] = FALSE;
+        if (mesh[i * 3 + 3]) {
+            rippleZ = calculate_ripple_at_point(painting, gPaintingMesh[i].pos[0], gPaintingMesh[i].pos[1]);
+            if (rippleZ != gPaintingMesh[i].pos[2]) {
+                gPaintingMesh[i].pos[2] = rippleZ;
+                sPaintingVertexMoved[i] = TRUE;
+            }
+        }
     }
 }
 
@@ -712,30 +752,39 @@ void painting_generate_mesh(struct Painting *painting, s16 *mesh, s16 numTris) {
  *      Where each v0, v1, v2 is an index into the first list in `mesh`.
  *
  * The mesh used in game, seg2_painting_triangle_mesh, is in bin/segment2.c.
+ *
+ * Only triangles with a vertex that moved are recalculated.
  */
 void painting_calculate_triangle_normals(s16 *mesh, s16 numVtx, s16 numTris) {
     s16 i;
 
-    gPaintingTriNorms = mem_pool_alloc(gEffectsMemoryPool, numTris * sizeof(Vec3f));
-    if (gPaintingTriNorms == NULL) {
-    }
     for (i = 0; i < numTris; i++) {
         s16 tri = numVtx * 3 + i * 3 + 2; // Add 2 because of the 2 length entries preceding the list
         s16 v0 = mesh[tri];
         s16 v1 = mesh[tri + 1];
         s16 v2 = mesh[tri + 2];
 
-        f32 x0 = gPaintingMesh[v0].pos[0];
-        f32 y0 = gPaintingMesh[v0].pos[1];
-        f32 z0 = gPaintingMesh[v0].pos[2];
+        f32 x0, y0, z0;
+        f32 x1, y1, z1;
+        f32 x2, y2, z2;
 
-        f32 x1 = gPaintingMesh[v1].pos[0];
-        f32 y1 = gPaintingMesh[v1].pos[1];
-        f32 z1 = gPaintingMesh[v1].pos[2];
+        sPaintingTriNormChanged[i] = sPaintingVertexMoved[v0] | sPaintingVertexMoved[v1]
+                                     | sPaintingVertexMoved[v2];
+        if (!sPaintingTriNormChanged[i]) {
+            continue;
+        }
 
-        f32 x2 = gPaintingMesh[v2].pos[0];
-        f32 y2 = gPaintingMesh[v2].pos[1];
-        f32 z2 = gPaintingMesh[v2].pos[2];
+        x0 = gPaintingMesh[v0].pos[0];
+        y0 = gPaintingMesh[v0].pos[1];
+        z0 = gPaintingMesh[v0].pos[2];
+
+        x1 = gPaintingMesh[v1].pos[0];
+        y1 = gPaintingMesh[v1].pos[1];
+        z1 = gPaintingMesh[v1].pos[2];
+
+        x2 = gPaintingMesh[v2].pos[0];
+        y2 = gPaintingMesh[v2].pos[1];
+        z2 = gPaintingMesh[v2].pos[2];
 
         // Cross product to find each triangle's normal vector
         gPaintingTriNorms[i][0] = (y1 - y0) * (z2 - z1) - (z1 - z0) * (y2 - y1);
@@ -792,6 +841,18 @@ void painting_average_vertex_normals(s16 *neighborTris, s16 numVtx) {
 
         // The first number of each entry is the number of adjacent tris
         neighbors = neighborTris[entry];
+
+        // Keep the old normal if none of the adjacent tris changed
+        for (j = 0; j < neighbors; j++) {
+            if (sPaintingTriNormChanged[neighborTris[entry + j + 1]]) {
+                break;
+            }
+        }
+        if (j == neighbors) {
+            entry += neighbors + 1;
+            continue;
+        }
+
         for (j = 0; j < neighbors; j++) {
             tri = neighborTris[entry + j + 1];
             nx += gPaintingTriNorms[tri][0];
@@ -1011,35 +1072,30 @@ Gfx *painting_ripple_env_mapped(struct Painting *painting) {
 }
 
 /**
- * Generates a mesh, calculates vertex normals for lighting, and renders a rippling painting.
- * The mesh and vertex normals are regenerated and freed every frame.
+ * Store the ripple parameters the mesh is generated with, and return whether they differ from
+ * the ones it was last generated with.
  */
-Gfx *display_painting_rippling(struct Painting *painting) {
-    s16 *mesh = segmented_to_virtual(seg2_painting_triangle_mesh);
-    s16 *neighborTris = segmented_to_virtual(seg2_painting_mesh_neighbor_tris);
-    s16 numVtx = mesh[0];
-    s16 numTris = mesh[numVtx * 3 + 1];
-    Gfx *dlist;
-
-    // Generate the mesh and its lighting data
-    painting_generate_mesh(painting, mesh, numVtx);
-    painting_calculate_triangle_normals(mesh, numVtx, numTris);
-    painting_average_vertex_normals(neighborTris, numVtx);
-
-    // Map the painting's texture depending on the painting's texture type.
-    switch (painting->textureType) {
-        case PAINTING_IMAGE:
-            dlist = painting_ripple_image(painting);
-            break;
-        case PAINTING_ENV_MAP:
-            dlist = painting_ripple_env_mapped(painting);
-            break;
+static s32 painting_ripple_changed(struct Painting *painting) {
+    f32 ripple[7];
+    s32 changed = FALSE;
+    s32 i;
+
+    ripple[0] = painting->currRippleMag;
+    ripple[1] = painting->currRippleRate;
+    ripple[2] = painting->dispersionFactor;
+    ripple[3] = painting->rippleTimer;
+    ripple[4] = painting->rippleX;
+    ripple[5] = painting->rippleY;
+    ripple[6] = painting->size;
+
+    for (i = 0; i < 7; i++) {
+        if (ripple[i] != sPaintingMeshRipple[i]) {
+            sPaintingMeshRipple[i] = ripple[i];
+            changed = TRUE;
+        }
     }
 
-    // The mesh data is freed every frame.
-    mem_pool_free(gEffectsMemoryPool, gPaintingMesh);
-    mem_pool_free(gEffectsMemoryPool, gPaintingTriNorms);
-    return dlist;
+    return changed;
 }
 
 /**
@@ -1059,6 +1115,43 @@ Gfx *display_painting_not_rippling(struct Painting *painting) {
     return dlist;
 }
 
+/**
+ * Updates the mesh, calculates vertex normals for lighting, and renders a rippling painting.
+ * The mesh is kept between frames: it is left as is when the ripple hasn't changed, and otherwise
+ * only the normals around vertices that moved are recalculated.
+ */
+Gfx *display_painting_rippling(struct Painting *painting) {
+    s16 *mesh = segmented_to_virtual(seg2_painting_triangle_mesh);
+    s16 *neighborTris = segmented_to_virtual(seg2_painting_mesh_neighbor_tris);
+    s16 numVtx = mesh[0];
+    s16 numTris = mesh[numVtx * 3 + 1];
+    Gfx *dlist;
+
+    // The mesh buffers are sized for seg2_painting_triangle_mesh; draw a bigger mesh flat instead
+    if (numVtx > PAINTING_MESH_NUM_VERTICES || numTris > PAINTING_MESH_NUM_TRIS) {
+        return display_painting_not_rippling(painting);
+    }
+
+    // Update the mesh and its lighting data
+    if (painting_ripple_changed(painting) || sPaintingMeshOwner != painting) {
+        painting_generate_mesh(painting, mesh, numVtx);
+        painting_calculate_triangle_normals(mesh, numVtx, numTris);
+        painting_average_vertex_normals(neighborTris, numVtx);
+    }
+
+    // Map the painting's texture depending on the painting's texture type.
+    switch (painting->textureType) {
+        case PAINTING_IMAGE:
+            dlist = painting_ripple_image(painting);
+            break;
+        case PAINTING_ENV_MAP:
+            dlist = painting_ripple_env_mapped(painting);
+            break;
+    }
+
+    return dlist;
+}
+
 /**
  * Clear Mario-related state and clear gRipplingPainting.
  */
@@ -1071,6 +1164,7 @@ void reset_painting(struct Painting *painting) {
     painting->marioWentUnder = 0;
 
     gRipplingPainting = NULL;
+    sPaintingMeshOwner = NULL;
 
 #ifdef NO_SEGMENTED_MEMORY
     // Make sure all variables are reset correctly.
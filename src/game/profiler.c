@@ -1,10 +1,15 @@
 #include <PR/ultratypes.h>
+#include <PR/os_exception.h>
+#include <PR/os_misc.h>
+#include <PR/os_thread.h>
 #include <PR/os_time.h>
 #include <PR/gbi.h>
 
 #include "sm64.h"
 #include "profiler.h"
 #include "game_init.h"
+#include "memory.h"
+#include "print.h"
 
 s16 gProfilerMode = 0;
 
@@ -58,6 +63,160 @@ void profiler_log_vblank_time(void) {
     }
 }
 
+#if PROFILER_ZONES
+// ring of zone events, written by any thread and drained by the USB thread.
+// The indices only ever increase and wrap around with the u32.
+#define PROFILER_ZONE_RING_SIZE 256
+
+struct ProfilerZoneEvent sProfilerZoneRing[PROFILER_ZONE_RING_SIZE];
+u32 sProfilerZoneWriteIndex = 0;
+u32 sProfilerZoneReadIndex = 0;
+u32 gProfilerZoneDroppedEvents = 0;
+
+// log the start or end of a zone, dropping the event if the ring is full.
+void profiler_log_zone(enum ProfilerZone zone, s32 type) {
+    struct ProfilerZoneEvent *event;
+    OSIntMask prevMask = osSetIntMask(OS_IM_NONE);
+
+    if (sProfilerZoneWriteIndex - sProfilerZoneReadIndex < PROFILER_ZONE_RING_SIZE) {
+        event = &sProfilerZoneRing[sProfilerZoneWriteIndex++ % PROFILER_ZONE_RING_SIZE];
+        event->time = osGetCount();
+        event->thread = osGetThreadId(NULL);
+        event->zone = zone;
+        event->type = type;
+    } else {
+        gProfilerZoneDroppedEvents++;
+    }
+
+    osSetIntMask(prevMask);
+}
+
+// take the oldest zone event out of the ring. returns FALSE if it was empty.
+s32 profiler_pop_zone_event(struct ProfilerZoneEvent *event) {
+    s32 popped = FALSE;
+    OSIntMask prevMask = osSetIntMask(OS_IM_NONE);
+
+    if (sProfilerZoneReadIndex != sProfilerZoneWriteIndex) {
+        *event = sProfilerZoneRing[sProfilerZoneReadIndex++ % PROFILER_ZONE_RING_SIZE];
+        popped = TRUE;
+    }
+
+    osSetIntMask(prevMask);
+    return popped;
+}
+#endif
+
+#if PROFILER_BEHAVIORS
+// open addressed table of the behaviors updated during the current window. The
+// size is a power of two comfortably above the behaviors loaded in any area.
+#define PROFILER_BEHAVIOR_TABLE_SIZE 256
+// number of behaviors listed on the profiler screen
+#define PROFILER_BEHAVIOR_SCREEN_COUNT 8
+// osGetCount ticks at 46.875 MHz
+#define CYCLES_TO_USEC(cycles) ((s32)((u64)(cycles) * 64 / 3000))
+
+struct ProfilerBehaviorStats sProfilerBehaviorTable[PROFILER_BEHAVIOR_TABLE_SIZE];
+s32 sProfilerBehaviorFrames = 0;
+u32 gProfilerBehaviorDroppedCalls = 0;
+
+// the last published window, read by tools/behavior_costs.py from a RAM dump
+struct ProfilerBehaviorDump gProfilerBehaviorDump;
+
+// add one cur_obj_update call to the stats of its behavior.
+void profiler_log_behavior(const BehaviorScript *behavior, u32 cycles) {
+    struct ProfilerBehaviorStats *stats;
+    u32 index = ((uintptr_t) behavior >> 2) & (PROFILER_BEHAVIOR_TABLE_SIZE - 1);
+    s32 probes;
+
+    for (probes = 0; probes < PROFILER_BEHAVIOR_TABLE_SIZE; probes++) {
+        stats = &sProfilerBehaviorTable[index];
+
+        if (stats->behavior == behavior || stats->behavior == NULL) {
+            stats->behavior = behavior;
+            stats->count++;
+            stats->totalCycles += cycles;
+            if (cycles > stats->maxCycles) {
+                stats->maxCycles = cycles;
+            }
+            return;
+        }
+
+        index = (index + 1) & (PROFILER_BEHAVIOR_TABLE_SIZE - 1);
+    }
+
+    gProfilerBehaviorDroppedCalls++;
+}
+
+// once per frame: at the end of each window, publish the most expensive
+// behaviors to gProfilerBehaviorDump and start counting again.
+void profiler_end_behavior_frame(void) {
+    struct ProfilerBehaviorDump *dump = &gProfilerBehaviorDump;
+    struct ProfilerBehaviorStats *stats;
+    s32 i, j;
+
+    if (++sProfilerBehaviorFrames < PROFILER_BEHAVIOR_WINDOW) {
+        return;
+    }
+
+    dump->numStats = 0;
+
+    for (i = 0; i < PROFILER_BEHAVIOR_TABLE_SIZE; i++) {
+        stats = &sProfilerBehaviorTable[i];
+        if (stats->behavior == NULL) {
+            continue;
+        }
+
+        // insert into the list, which is kept sorted by total cycles
+        if (dump->numStats < PROFILER_BEHAVIOR_DUMP_COUNT) {
+            j = dump->numStats++;
+        } else if (stats->totalCycles > dump->stats[PROFILER_BEHAVIOR_DUMP_COUNT - 1].totalCycles) {
+            j = PROFILER_BEHAVIOR_DUMP_COUNT - 1;
+        } else {
+            j = -1;
+        }
+
+        if (j >= 0) {
+            while (j > 0 && dump->stats[j - 1].totalCycles < stats->totalCycles) {
+                dump->stats[j] = dump->stats[j - 1];
+                j--;
+            }
+            dump->stats[j] = *stats;
+        }
+
+        stats->behavior = NULL;
+        stats->count = 0;
+        stats->totalCycles = 0;
+        stats->maxCycles = 0;
+    }
+
+    dump->magic = PROFILER_BEHAVIOR_MAGIC;
+    dump->frames = sProfilerBehaviorFrames;
+    dump->sequence++;
+    sProfilerBehaviorFrames = 0;
+}
+
+// list the most expensive behaviors of the last window: behavior offset in
+// segment 0x13, average microseconds per frame and the longest single update.
+void profiler_print_behavior_stats(void) {
+    struct ProfilerBehaviorDump *dump = &gProfilerBehaviorDump;
+    struct ProfilerBehaviorStats *stats;
+    s32 i;
+
+    if (dump->frames == 0) {
+        return;
+    }
+
+    for (i = 0; i < (s32) dump->numStats && i < PROFILER_BEHAVIOR_SCREEN_COUNT; i++) {
+        stats = &dump->stats[i];
+        print_text_fmt_int(16, 200 - i * 18, "%x",
+                           (uintptr_t) virtual_to_segmented(0x13, stats->behavior) & 0xFFFFFF);
+        print_text_fmt_int(128, 200 - i * 18, "%d",
+                           CYCLES_TO_USEC(stats->totalCycles / dump->frames));
+        print_text_fmt_int(208, 200 - i * 18, "%d", CYCLES_TO_USEC(stats->maxCycles));
+    }
+}
+#endif
+
 // draw the specified profiler given the information passed.
 void draw_profiler_bar(OSTime clockBase, OSTime clockStart, OSTime clockEnd, s16 posY, u16 color) {
     s64 durationStart, durationEnd;
@@ -42,10 +42,69 @@ enum ProfilerGfxEvent {
     RDP_COMPLETE
 };
 
+// timing zones, which may nest within the same thread
+enum ProfilerZone {
+    PROFILER_ZONE_LEVEL_SCRIPT,
+    PROFILER_ZONE_OBJECTS,
+    PROFILER_ZONE_OBJECT_COLLISION,
+    PROFILER_ZONE_GRAPH,
+    PROFILER_ZONE_AUDIO,
+    PROFILER_ZONE_USB,
+    PROFILER_ZONE_ENVFX,
+    PROFILER_ZONE_COUNT
+};
+
+#define PROFILER_ZONE_EVENT_BEGIN 0
+#define PROFILER_ZONE_EVENT_END 1
+
+struct ProfilerZoneEvent {
+    /* 0x00 */ u32 time; // osGetCount
+    /* 0x04 */ u8 thread;
+    /* 0x05 */ u8 zone;
+    /* 0x06 */ u8 type;
+    /* 0x07 */ u8 pad;
+};
+
+// per-behavior update costs, published every PROFILER_BEHAVIOR_WINDOW frames
+// sorted from most to least expensive
+#define PROFILER_BEHAVIOR_WINDOW 30
+#define PROFILER_BEHAVIOR_DUMP_COUNT 32
+#define PROFILER_BEHAVIOR_MAGIC 0x42485650 // "BHVP"
+
+struct ProfilerBehaviorStats {
+    /* 0x00 */ const BehaviorScript *behavior;
+    /* 0x04 */ u32 count;
+    /* 0x08 */ u32 totalCycles; // osGetCount
+    /* 0x0C */ u32 maxCycles;
+};
+
+struct ProfilerBehaviorDump {
+    /* 0x00 */ u32 magic;
+    /* 0x04 */ u32 sequence;
+    /* 0x08 */ u32 frames;
+    /* 0x0C */ u32 numStats;
+    /* 0x10 */ struct ProfilerBehaviorStats stats[PROFILER_BEHAVIOR_DUMP_COUNT];
+};
+
+extern struct ProfilerBehaviorDump gProfilerBehaviorDump;
+
+#if PROFILER_ZONES
+#define PROFILER_ZONE_BEGIN(zone) profiler_log_zone(zone, PROFILER_ZONE_EVENT_BEGIN)
+#define PROFILER_ZONE_END(zone) profiler_log_zone(zone, PROFILER_ZONE_EVENT_END)
+#else
+#define PROFILER_ZONE_BEGIN(zone)
+#define PROFILER_ZONE_END(zone)
+#endif
+
 void profiler_log_thread5_time(enum ProfilerGameEvent eventID);
 void profiler_log_thread4_time(void);
 void profiler_log_gfx_time(enum ProfilerGfxEvent eventID);
 void profiler_log_vblank_time(void);
 void draw_profiler(void);
+void profiler_log_zone(enum ProfilerZone zone, s32 type);
+s32 profiler_pop_zone_event(struct ProfilerZoneEvent *event);
+void profiler_log_behavior(const BehaviorScript *behavior, u32 cycles);
+void profiler_end_behavior_frame(void);
+void profiler_print_behavior_stats(void);
 
 #endif // PROFILER_H
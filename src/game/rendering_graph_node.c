@@ -67,6 +67,26 @@ s16 *gCurrAnimData;
 
 struct AllocOnlyPool *gDisplayListHeap;
 
+#define ANIM_JOINT_CACHE_SIZE 32 // must be a power of two
+
+/**
+ * Local transform of an animated part, computed for some animation frame.
+ * Objects sharing a model and playing the same animation at the same frame
+ * (e.g. a group of goombas) end up with identical local transforms for each
+ * joint, so these are cached for the duration of one area update.
+ */
+struct AnimJointCacheEntry {
+    struct GraphNodeAnimatedPart *node;
+    u16 *attribute;
+    s16 *data;
+    s16 frame;
+    u16 timestamp;
+    Mat4 matrix;
+};
+
+static struct AnimJointCacheEntry sAnimJointCache[ANIM_JOINT_CACHE_SIZE];
+static s32 sAnimJointCacheHits; // joint transforms reused in the current frame
+
 struct RenderModeContainer {
     u32 modes[8];
 };
@@ -224,6 +244,10 @@ static void geo_process_ortho_projection(struct GraphNodeOrthoProjection *node)
         f32 top = (gCurGraphNodeRoot->y - gCurGraphNodeRoot->height) / 2.0f * node->scale;
         f32 bottom = (gCurGraphNodeRoot->y + gCurGraphNodeRoot->height) / 2.0f * node->scale;
 
+        if (mtx == NULL) {
+            return;
+        }
+
         guOrtho(mtx, left, right, bottom, top, -2.0f, 2.0f, 1.0f);
         gSPPerspNormalize(gDisplayListHead++, 0xFFFF);
         gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(mtx), G_MTX_PROJECTION | G_MTX_LOAD | G_MTX_NOPUSH);
@@ -249,6 +273,10 @@ static void geo_process_perspective(struct GraphNodePerspective *node) {
         f32 aspect = (f32) gCurGraphNodeRoot->width / (f32) gCurGraphNodeRoot->height;
 #endif
 
+        if (mtx == NULL) {
+            return;
+        }
+
         guPerspective(mtx, &perspNorm, node->fov, aspect, node->near, node->far, 1.0f);
         gSPPerspNormalize(gDisplayListHead++, perspNorm);
 
@@ -315,6 +343,9 @@ static void geo_process_camera(struct GraphNodeCamera *node) {
     if (node->fnNode.func != NULL) {
         node->fnNode.func(GEO_CONTEXT_RENDER, &node->fnNode.node, gMatStack[gMatStackIndex]);
     }
+    if (rollMtx == NULL || mtx == NULL) {
+        return;
+    }
     mtxf_rotate_xy(rollMtx, node->rollScreen);
 
     gSPMatrix(gDisplayListHead++, VIRTUAL_TO_PHYSICAL(rollMtx), G_MTX_PROJECTION | G_MTX_MUL | G_MTX_NOPUSH);
@@ -344,9 +375,18 @@ static void geo_process_translation_rotation(struct GraphNodeTranslationRotation
     Vec3f translation;
     Mtx *mtx = alloc_display_list(sizeof(*mtx));
 
+    if (mtx == NULL) {
+        return;
+    }
+
     vec3s_to_vec3f(translation, node->translation);
-    mtxf_rotate_zxy_and_translate(mtxf, translation, node->rotation);
-    mtxf_mul(gMatStack[gMatStackIndex + 1], mtxf, gMatStack[gMatStackIndex]);
+    if (node->rotation[0] == 0 && node->rotation[2] == 0) {
+        mtxf_rotate_y_translate_mul(gMatStack[gMatStackIndex + 1], translation, node->rotation[1],
+                                    gMatStack[gMatStackIndex]);
+    } else {
+        mtxf_rotate_zxy_and_translate(mtxf, translation, node->rotation);
+        mtxf_mul(gMatStack[gMatStackIndex + 1], mtxf, gMatStack[gMatStackIndex]);
+    }
     gMatStackIndex++;
     mtxf_to_mtx(mtx, gMatStack[gMatStackIndex]);
     gMatStackFixed[gMatStackIndex] = mtx;
@@ -365,13 +405,16 @@ static void geo_process_translation_rotation(struct GraphNodeTranslationRotation
  * For the rest it acts as a normal display list node.
  */
 static void geo_process_translation(struct GraphNodeTranslation *node) {
-    Mat4 mtxf;
     Vec3f translation;
     Mtx *mtx = alloc_display_list(sizeof(*mtx));
 
+    if (mtx == NULL) {
+        return;
+    }
+
     vec3s_to_vec3f(translation, node->translation);
-    mtxf_rotate_zxy_and_translate(mtxf, translation, gVec3sZero);
-    mtxf_mul(gMatStack[gMatStackIndex + 1], mtxf, gMatStack[gMatStackIndex]);
+    mtxf_rotate_y_translate_mul(gMatStack[gMatStackIndex + 1], translation, 0,
+                                gMatStack[gMatStackIndex]);
     gMatStackIndex++;
     mtxf_to_mtx(mtx, gMatStack[gMatStackIndex]);
     gMatStackFixed[gMatStackIndex] = mtx;
@@ -393,6 +436,10 @@ static void geo_process_rotation(struct GraphNodeRotation *node) {
     Mat4 mtxf;
     Mtx *mtx = alloc_display_list(sizeof(*mtx));
 
+    if (mtx == NULL) {
+        return;
+    }
+
     mtxf_rotate_zxy_and_translate(mtxf, gVec3fZero, node->rotation);
     mtxf_mul(gMatStack[gMatStackIndex + 1], mtxf, gMatStack[gMatStackIndex]);
     gMatStackIndex++;
@@ -417,6 +464,10 @@ static void geo_process_scale(struct GraphNodeScale *node) {
     Vec3f scaleVec;
     Mtx *mtx = alloc_display_list(sizeof(*mtx));
 
+    if (mtx == NULL) {
+        return;
+    }
+
     vec3f_set(scaleVec, node->scale, node->scale, node->scale);
     mtxf_scale_vec3f(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex], scaleVec);
     gMatStackIndex++;
@@ -441,6 +492,10 @@ static void geo_process_billboard(struct GraphNodeBillboard *node) {
     Vec3f translation;
     Mtx *mtx = alloc_display_list(sizeof(*mtx));
 
+    if (mtx == NULL) {
+        return;
+    }
+
     gMatStackIndex++;
     vec3s_to_vec3f(translation, node->translation);
     mtxf_billboard(gMatStack[gMatStackIndex], gMatStack[gMatStackIndex - 1], translation,
@@ -521,6 +576,10 @@ static void geo_process_background(struct GraphNodeBackground *node) {
 #endif
         Gfx *gfx = gfxStart;
 
+        if (gfxStart == NULL) {
+            return;
+        }
+
         gDPPipeSync(gfx++);
         gDPSetCycleType(gfx++, G_CYC_FILL);
         gDPSetFillColor(gfx++, node->background);
@@ -537,6 +596,23 @@ static void geo_process_background(struct GraphNodeBackground *node) {
     }
 }
 
+/**
+ * Find the cache slot for the joint that is about to read its rotation from
+ * gCurrAnimAttribute, and report whether it already holds that joint's
+ * transform for the current frame.
+ */
+static struct AnimJointCacheEntry *anim_joint_cache_find(struct GraphNodeAnimatedPart *node,
+                                                         s32 *hit) {
+    struct AnimJointCacheEntry *entry =
+        &sAnimJointCache[(((uintptr_t) gCurrAnimAttribute >> 2) ^ gCurrAnimFrame)
+                         & (ANIM_JOINT_CACHE_SIZE - 1)];
+
+    *hit = entry->node == node && entry->attribute == gCurrAnimAttribute
+           && entry->data == gCurrAnimData && entry->frame == gCurrAnimFrame
+           && entry->timestamp == gAreaUpdateCounter;
+    return entry;
+}
+
 /**
  * Render an animated part. The current animation state is not part of the node
  * but set in global variables. If an animated part is skipped, everything afterwards desyncs.
@@ -546,48 +622,85 @@ static void geo_process_animated_part(struct GraphNodeAnimatedPart *node) {
     Vec3s rotation;
     Vec3f translation;
     Mtx *matrixPtr = alloc_display_list(sizeof(*matrixPtr));
+    struct AnimJointCacheEntry *cacheEntry = NULL;
+    s32 cacheHit = FALSE;
+
+    // Out of gfx pool space. Skipping the joint desyncs the animation of the
+    // joints after it, but with the pool full those are skipped as well.
+    if (matrixPtr == NULL) {
+        return;
+    }
 
-    vec3s_copy(rotation, gVec3sZero);
-    vec3f_set(translation, node->translation[0], node->translation[1], node->translation[2]);
-    if (gCurrAnimType == ANIM_TYPE_TRANSLATION) {
-        translation[0] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[1] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        translation[2] += gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
-                          * gCurrAnimTranslationMultiplier;
-        gCurrAnimType = ANIM_TYPE_ROTATION;
+    // Only joints that read nothing but a rotation depend on no per-object
+    // state (the translation multiplier), so only those are cached.
+    if (gCurrAnimType == ANIM_TYPE_ROTATION) {
+        cacheEntry = anim_joint_cache_find(node, &cacheHit);
+    }
+
+    if (cacheHit) {
+        gCurrAnimAttribute += 6;
+        mtxf_copy(matrix, cacheEntry->matrix);
+        sAnimJointCacheHits++;
     } else {
-        if (gCurrAnimType == ANIM_TYPE_LATERAL_TRANSLATION) {
+        if (cacheEntry != NULL) {
+            cacheEntry->node = node;
+            cacheEntry->attribute = gCurrAnimAttribute;
+            cacheEntry->data = gCurrAnimData;
+            cacheEntry->frame = gCurrAnimFrame;
+            cacheEntry->timestamp = gAreaUpdateCounter;
+        }
+
+        vec3s_copy(rotation, gVec3sZero);
+        vec3f_set(translation, node->translation[0], node->translation[1], node->translation[2]);
+        if (gCurrAnimType == ANIM_TYPE_TRANSLATION) {
             translation[0] +=
                 gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
                 * gCurrAnimTranslationMultiplier;
-            gCurrAnimAttribute += 2;
+            translation[1] +=
+                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
+                * gCurrAnimTranslationMultiplier;
             translation[2] +=
                 gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
                 * gCurrAnimTranslationMultiplier;
             gCurrAnimType = ANIM_TYPE_ROTATION;
         } else {
-            if (gCurrAnimType == ANIM_TYPE_VERTICAL_TRANSLATION) {
-                gCurrAnimAttribute += 2;
-                translation[1] +=
+            if (gCurrAnimType == ANIM_TYPE_LATERAL_TRANSLATION) {
+                translation[0] +=
                     gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
                     * gCurrAnimTranslationMultiplier;
                 gCurrAnimAttribute += 2;
+                translation[2] +=
+                    gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
+                    * gCurrAnimTranslationMultiplier;
                 gCurrAnimType = ANIM_TYPE_ROTATION;
-            } else if (gCurrAnimType == ANIM_TYPE_NO_TRANSLATION) {
-                gCurrAnimAttribute += 6;
-                gCurrAnimType = ANIM_TYPE_ROTATION;
+            } else {
+                if (gCurrAnimType == ANIM_TYPE_VERTICAL_TRANSLATION) {
+                    gCurrAnimAttribute += 2;
+                    translation[1] +=
+                        gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)]
+                        * gCurrAnimTranslationMultiplier;
+                    gCurrAnimAttribute += 2;
+                    gCurrAnimType = ANIM_TYPE_ROTATION;
+                } else if (gCurrAnimType == ANIM_TYPE_NO_TRANSLATION) {
+                    gCurrAnimAttribute += 6;
+                    gCurrAnimType = ANIM_TYPE_ROTATION;
+                }
             }
         }
-    }
 
-    if (gCurrAnimType == ANIM_TYPE_ROTATION) {
-        rotation[0] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[1] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
-        rotation[2] = gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
+        if (gCurrAnimType == ANIM_TYPE_ROTATION) {
+            rotation[0] =
+                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
+            rotation[1] =
+                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
+            rotation[2] =
+                gCurrAnimData[retrieve_animation_index(gCurrAnimFrame, &gCurrAnimAttribute)];
+        }
+        mtxf_rotate_xyz_and_translate(matrix, translation, rotation);
+        if (cacheEntry != NULL) {
+            mtxf_copy(cacheEntry->matrix, matrix);
+        }
     }
-    mtxf_rotate_xyz_and_translate(matrix, translation, rotation);
     mtxf_mul(gMatStack[gMatStackIndex + 1], matrix, gMatStack[gMatStackIndex]);
     gMatStackIndex++;
     mtxf_to_mtx(matrixPtr, gMatStack[gMatStackIndex]);
@@ -690,8 +803,7 @@ static void geo_process_shadow(struct GraphNodeShadow *node) {
 
         shadowList = create_shadow_below_xyz(shadowPos[0], shadowPos[1], shadowPos[2], shadowScale,
                                              node->shadowSolidity, node->shadowType);
-        if (shadowList != NULL) {
-            mtx = alloc_display_list(sizeof(*mtx));
+        if (shadowList != NULL && (mtx = alloc_display_list(sizeof(*mtx))) != NULL) {
             gMatStackIndex++;
             mtxf_translate(mtxf, shadowPos);
             mtxf_mul(gMatStack[gMatStackIndex], mtxf, *gCurGraphNodeCamera->matrixPtr);
@@ -802,11 +914,26 @@ static s32 obj_is_in_view(struct GraphNodeObject *node, Mat4 matrix) {
     return TRUE;
 }
 
+/**
+ * Check whether enough of the gfx pool is left to draw another object. Besides
+ * GFX_POOL_RESERVE, there must be room to emit the master list entries of every
+ * display list appended so far, since that only happens after the traversal.
+ * Objects that would not fit are skipped rather than letting alloc_display_list
+ * run out while building matrices.
+ */
+static s32 gfx_pool_has_room_for_object(void) {
+    s32 pendingLists = gDisplayListHeap->usedSpace / (s32) sizeof(struct DisplayListNode);
+    s32 remaining = gGfxPoolEnd - (u8 *) gDisplayListHead;
+
+    return remaining > GFX_POOL_RESERVE + pendingLists * 2 * (s32) sizeof(Gfx);
+}
+
 /**
  * Process an object node.
  */
 static void geo_process_object(struct Object *node) {
     Mat4 mtxf;
+    Mtx *mtx;
     s32 hasAnimation = (node->header.gfx.node.flags & GRAPH_RENDER_HAS_ANIMATION) != 0;
 
     if (node->header.gfx.areaIndex == gCurGraphNodeRoot->areaIndex) {
@@ -816,6 +943,9 @@ static void geo_process_object(struct Object *node) {
         } else if (node->header.gfx.node.flags & GRAPH_RENDER_BILLBOARD) {
             mtxf_billboard(gMatStack[gMatStackIndex + 1], gMatStack[gMatStackIndex],
                            node->header.gfx.pos, gCurGraphNodeCamera->roll);
+        } else if (node->header.gfx.angle[0] == 0 && node->header.gfx.angle[2] == 0) {
+            mtxf_rotate_y_translate_mul(gMatStack[gMatStackIndex + 1], node->header.gfx.pos,
+                                        node->header.gfx.angle[1], gMatStack[gMatStackIndex]);
         } else {
             mtxf_rotate_zxy_and_translate(mtxf, node->header.gfx.pos, node->header.gfx.angle);
             mtxf_mul(gMatStack[gMatStackIndex + 1], mtxf, gMatStack[gMatStackIndex]);
@@ -832,9 +962,9 @@ static void geo_process_object(struct Object *node) {
         if (node->header.gfx.animInfo.curAnim != NULL) {
             geo_set_animation_globals(&node->header.gfx.animInfo, hasAnimation);
         }
-        if (obj_is_in_view(&node->header.gfx, gMatStack[gMatStackIndex])) {
-            Mtx *mtx = alloc_display_list(sizeof(*mtx));
-
+        if (obj_is_in_view(&node->header.gfx, gMatStack[gMatStackIndex])
+            && gfx_pool_has_room_for_object()
+            && (mtx = alloc_display_list(sizeof(*mtx))) != NULL) {
             mtxf_to_mtx(mtx, gMatStack[gMatStackIndex]);
             gMatStackFixed[gMatStackIndex] = mtx;
             if (node->header.gfx.sharedChild != NULL) {
@@ -886,6 +1016,9 @@ void geo_process_held_object(struct GraphNodeHeldObject *node) {
     if (node->fnNode.func != NULL) {
         node->fnNode.func(GEO_CONTEXT_RENDER, &node->fnNode.node, gMatStack[gMatStackIndex]);
     }
+    if (mtx == NULL) {
+        return;
+    }
     if (node->objNode != NULL && node->objNode->header.gfx.sharedChild != NULL) {
         s32 hasAnimation = (node->objNode->header.gfx.node.flags & GRAPH_RENDER_HAS_ANIMATION) != 0;
 
@@ -1053,8 +1186,13 @@ void geo_process_root(struct GraphNodeRoot *node, Vp *b, Vp *c, s32 clearColor)
         gDisplayListHeap = alloc_only_pool_init(main_pool_available() - sizeof(struct AllocOnlyPool),
                                                 MEMORY_POOL_LEFT);
         initialMatrix = alloc_display_list(sizeof(*initialMatrix));
+        if (viewport == NULL || initialMatrix == NULL) {
+            main_pool_free(gDisplayListHeap);
+            return;
+        }
         gMatStackIndex = 0;
         gCurrAnimType = 0;
+        sAnimJointCacheHits = 0;
         vec3s_set(viewport->vp.vtrans, node->x * 4, node->y * 4, 511);
         vec3s_set(viewport->vp.vscale, node->width * 4, node->height * 4, 511);
         if (b != NULL) {
@@ -1082,6 +1220,7 @@ void geo_process_root(struct GraphNodeRoot *node, Vp *b, Vp *c, s32 clearColor)
         if (gShowDebugText) {
             print_text_fmt_int(180, 36, "MEM %d",
                                gDisplayListHeap->totalSpace - gDisplayListHeap->usedSpace);
+            print_text_fmt_int(180, 68, "ANIM %d", sAnimJointCacheHits);
         }
         main_pool_free(gDisplayListHeap);
     }
@@ -15,6 +15,11 @@
 #define MENU_DATA_MAGIC 0x4849
 #define SAVE_FILE_MAGIC 0x4441
 
+#define EEPROM_NUM_BLOCKS (EEPROM_SIZE / EEPROM_BLOCK_SIZE)
+// time the EEPROM needs to finish writing a block, as waited for by osEepromLongWrite,
+// in osGetTime counts (46.875 MHz)
+#define EEPROM_WRITE_CYCLE_COUNTS (12000 * 375 / 8)
+
 STATIC_ASSERT(sizeof(struct SaveBuffer) == EEPROM_SIZE, "eeprom buffer size must match");
 
 extern struct SaveBuffer gSaveBuffer;
@@ -32,6 +37,18 @@ u8 gCurrCourseStarFlags = 0;
 
 u8 gSpecialTripleJump = FALSE;
 
+// EEPROM contents as last read or written, used to skip blocks that did not change
+static struct SaveBuffer sEepromContents;
+// signed data waiting to be written, so later changes to gSaveBuffer can't tear it
+static struct SaveBuffer sEepromPending;
+// one bit per EEPROM block of sEepromPending that may differ from sEepromContents
+static u32 sDirtyEepromBlocks[EEPROM_NUM_BLOCKS / 32];
+// signed save files and menu data whose blocks are not queued for writing yet
+static u8 sUnwrittenSaveFiles = 0;
+static u8 sMainMenuDataUnwritten = FALSE;
+static OSTime sLastEepromWriteTime = 0;
+static u8 sEepromWriteFailures = 0;
+
 #define STUB_LEVEL(_0, _1, courseenum, _3, _4, _5, _6, _7, _8) courseenum,
 #define DEFINE_LEVEL(_0, _1, courseenum, _3, _4, _5, _6, _7, _8, _9, _10) courseenum,
 
@@ -79,31 +96,70 @@ static s32 read_eeprom_data(void *buffer, s32 size) {
 }
 
 /**
- * Write data to EEPROM.
- * The EEPROM address is computed using the offset of the source address from gSaveBuffer.
- * Try at most 4 times, and return 0 on success. On failure, return the status returned from
- * osEepromLongWrite. Unlike read_eeprom_data, return 1 if EEPROM isn't loaded.
+ * Mark the EEPROM blocks backing a part of gSaveBuffer as needing to be written,
+ * with `data` as their new contents. `size` is a multiple of the block size.
  */
-static s32 write_eeprom_data(void *buffer, s32 size) {
-    s32 status = 1;
+static void mark_eeprom_dirty(void *buffer, void *data, s32 size) {
+    u32 block = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer) / EEPROM_BLOCK_SIZE;
+    u32 end = block + size / EEPROM_BLOCK_SIZE;
 
-    if (gEepromProbe != 0) {
-        s32 triesLeft = 4;
-        u32 offset = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer) >> 3;
+    bcopy(data, (u8 *) &sEepromPending + block * EEPROM_BLOCK_SIZE, size);
 
-        do {
-#if ENABLE_RUMBLE
-            block_until_rumble_pak_free();
-#endif
-            triesLeft--;
-            status = osEepromLongWrite(&gSIEventMesgQueue, offset, buffer, size);
-#if ENABLE_RUMBLE
-            release_rumble_pak_control();
-#endif
-        } while (triesLeft > 0 && status != 0);
+    for (; block < end; block++) {
+        sDirtyEepromBlocks[block / 32] |= 1 << (block % 32);
     }
+}
 
-    return status;
+/**
+ * Return whether any EEPROM block backing a part of gSaveBuffer is still
+ * waiting to be written.
+ */
+static s32 eeprom_range_dirty(void *buffer, s32 size) {
+    u32 block = (u32)((u8 *) buffer - (u8 *) &gSaveBuffer) / EEPROM_BLOCK_SIZE;
+    u32 end = block + size / EEPROM_BLOCK_SIZE;
+
+    for (; block < end; block++) {
+        if (sDirtyEepromBlocks[block / 32] & (1 << (block % 32))) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static s32 eeprom_block_changed(s32 block) {
+    u8 *data = (u8 *) &sEepromPending + block * EEPROM_BLOCK_SIZE;
+    u8 *written = (u8 *) &sEepromContents + block * EEPROM_BLOCK_SIZE;
+    s32 i;
+
+    for (i = 0; i < EEPROM_BLOCK_SIZE; i++) {
+        if (data[i] != written[i]) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Find the next dirty block and clear its dirty bit. Blocks that already match
+ * the EEPROM are dropped. Return -1 if nothing is left to write.
+ */
+static s32 pop_dirty_eeprom_block(void) {
+    s32 block;
+    u32 mask;
+
+    for (block = 0; block < EEPROM_NUM_BLOCKS; block++) {
+        mask = 1 << (block % 32);
+        if (sDirtyEepromBlocks[block / 32] & mask) {
+            sDirtyEepromBlocks[block / 32] &= ~mask;
+            if (eeprom_block_changed(block)) {
+                return block;
+            }
+        }
+    }
+
+    return -1;
 }
 
 /**
@@ -156,8 +212,9 @@ static void restore_main_menu_data(s32 srcSlot) {
     // Copy source data to destination
     bcopy(&gSaveBuffer.menuData[srcSlot], &gSaveBuffer.menuData[destSlot], sizeof(gSaveBuffer.menuData[destSlot]));
 
-    // Write destination data to EEPROM
-    write_eeprom_data(&gSaveBuffer.menuData[destSlot], sizeof(gSaveBuffer.menuData[destSlot]));
+    // Queue destination data for writing to EEPROM
+    mark_eeprom_dirty(&gSaveBuffer.menuData[destSlot], &gSaveBuffer.menuData[destSlot],
+                      sizeof(gSaveBuffer.menuData[destSlot]));
 }
 
 static void save_main_menu_data(void) {
@@ -168,8 +225,8 @@ static void save_main_menu_data(void) {
         // Back up data
         bcopy(&gSaveBuffer.menuData[0], &gSaveBuffer.menuData[1], sizeof(gSaveBuffer.menuData[1]));
 
-        // Write to EEPROM
-        write_eeprom_data(gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData));
+        // Written to EEPROM by save_file_update_eeprom
+        sMainMenuDataUnwritten = TRUE;
 
         gMainMenuDataModified = FALSE;
     }
@@ -244,11 +301,121 @@ static void restore_save_file_data(s32 fileIndex, s32 srcSlot) {
     bcopy(&gSaveBuffer.files[fileIndex][srcSlot], &gSaveBuffer.files[fileIndex][destSlot],
           sizeof(gSaveBuffer.files[fileIndex][destSlot]));
 
-    // Write destination data to EEPROM
-    write_eeprom_data(&gSaveBuffer.files[fileIndex][destSlot],
+    // Queue destination data for writing to EEPROM
+    mark_eeprom_dirty(&gSaveBuffer.files[fileIndex][destSlot], &gSaveBuffer.files[fileIndex][destSlot],
                       sizeof(gSaveBuffer.files[fileIndex][destSlot]));
 }
 
+/**
+ * Mark the blocks of the save files and main menu data saved since the last
+ * call for writing. Several saves in a frame thus cost a single write.
+ * A save file or the menu data is only marked once its previous write is done.
+ * Otherwise its primary slot could be rewritten while the backup slot is only
+ * partly written, and neither copy would be valid until both finished. The
+ * blocks are written from the backup slot, which only changes when saving, so
+ * changes made to the primary slot after the save can't tear it either.
+ */
+static void commit_pending_saves(void) {
+    s32 fileIndex;
+
+    for (fileIndex = 0; fileIndex < NUM_SAVE_FILES; fileIndex++) {
+        if ((sUnwrittenSaveFiles & (1 << fileIndex))
+            && !eeprom_range_dirty(gSaveBuffer.files[fileIndex], sizeof(gSaveBuffer.files[fileIndex]))) {
+            mark_eeprom_dirty(&gSaveBuffer.files[fileIndex][0], &gSaveBuffer.files[fileIndex][1],
+                              sizeof(gSaveBuffer.files[fileIndex][0]));
+            mark_eeprom_dirty(&gSaveBuffer.files[fileIndex][1], &gSaveBuffer.files[fileIndex][1],
+                              sizeof(gSaveBuffer.files[fileIndex][1]));
+            sUnwrittenSaveFiles &= ~(1 << fileIndex);
+        }
+    }
+
+    if (sMainMenuDataUnwritten && !eeprom_range_dirty(gSaveBuffer.menuData, sizeof(gSaveBuffer.menuData))) {
+        mark_eeprom_dirty(&gSaveBuffer.menuData[0], &gSaveBuffer.menuData[1], sizeof(gSaveBuffer.menuData[0]));
+        mark_eeprom_dirty(&gSaveBuffer.menuData[1], &gSaveBuffer.menuData[1], sizeof(gSaveBuffer.menuData[1]));
+        sMainMenuDataUnwritten = FALSE;
+    }
+}
+
+/**
+ * Write a block of sEepromPending to EEPROM, without waiting for the write to
+ * finish. Return 0 on success, as osEepromWrite does.
+ */
+static s32 write_eeprom_block(s32 block) {
+    s32 status = 0;
+
+    if (gEepromProbe != 0) {
+#if ENABLE_RUMBLE
+        block_until_rumble_pak_free();
+#endif
+        status = osEepromWrite(&gSIEventMesgQueue, block, (u8 *) &sEepromPending + block * EEPROM_BLOCK_SIZE);
+#if ENABLE_RUMBLE
+        release_rumble_pak_control();
+#endif
+        sLastEepromWriteTime = osGetTime();
+    }
+
+    if (status == 0) {
+        bcopy((u8 *) &sEepromPending + block * EEPROM_BLOCK_SIZE,
+              (u8 *) &sEepromContents + block * EEPROM_BLOCK_SIZE, EEPROM_BLOCK_SIZE);
+    }
+
+    return status;
+}
+
+/**
+ * Write at most one changed block to EEPROM. Called once per frame by the game
+ * loop, which spaces the writes further apart than the EEPROM's write cycle, so
+ * unlike osEepromLongWrite this never waits for the EEPROM.
+ */
+void save_file_update_eeprom(void) {
+    s32 block;
+
+    commit_pending_saves();
+
+    if (osGetTime() - sLastEepromWriteTime < (OSTime) EEPROM_WRITE_CYCLE_COUNTS) {
+        return;
+    }
+
+    block = pop_dirty_eeprom_block();
+    if (block < 0) {
+        return;
+    }
+
+    if (write_eeprom_block(block) == 0) {
+        sEepromWriteFailures = 0;
+    } else if (++sEepromWriteFailures < 4) {
+        // try again next frame, up to 4 times in all
+        sDirtyEepromBlocks[block / 32] |= 1 << (block % 32);
+    } else {
+        sEepromWriteFailures = 0;
+    }
+}
+
+/**
+ * Write everything saved so far to EEPROM before returning. Used at points where
+ * the game may not get to finish the writes frame by frame, such as a reset.
+ */
+void save_file_flush_eeprom(void) {
+    s32 block;
+    s32 triesLeft;
+
+    // saves held back by commit_pending_saves are committed once the writes
+    // before them are done
+    do {
+        commit_pending_saves();
+
+        while ((block = pop_dirty_eeprom_block()) >= 0) {
+            triesLeft = 4;
+            do {
+                // let the previous write finish
+                while (osGetTime() - sLastEepromWriteTime < (OSTime) EEPROM_WRITE_CYCLE_COUNTS) {
+                }
+                triesLeft--;
+            } while (write_eeprom_block(block) != 0 && triesLeft > 0);
+        }
+    } while (sUnwrittenSaveFiles != 0 || sMainMenuDataUnwritten);
+}
+
 void save_file_do_save(s32 fileIndex) {
     if (gSaveFileModified) {
         // Compute checksum
@@ -259,8 +426,8 @@ void save_file_do_save(s32 fileIndex) {
         bcopy(&gSaveBuffer.files[fileIndex][0], &gSaveBuffer.files[fileIndex][1],
               sizeof(gSaveBuffer.files[fileIndex][1]));
 
-        // Write to EEPROM
-        write_eeprom_data(gSaveBuffer.files[fileIndex], sizeof(gSaveBuffer.files[fileIndex]));
+        // Written to EEPROM by save_file_update_eeprom
+        sUnwrittenSaveFiles |= 1 << fileIndex;
 
         gSaveFileModified = FALSE;
     }
@@ -297,6 +464,7 @@ void save_file_load_all(void) {
 
     bzero(&gSaveBuffer, sizeof(gSaveBuffer));
     read_eeprom_data(&gSaveBuffer, sizeof(gSaveBuffer));
+    bcopy(&gSaveBuffer, &sEepromContents, sizeof(sEepromContents));
 
     // Verify the main menu data and create a backup copy if only one of the slots is valid.
     validSlots = verify_save_block_signature(&gSaveBuffer.menuData[0], sizeof(gSaveBuffer.menuData[0]), MENU_DATA_MAGIC);
@@ -126,6 +126,8 @@ extern s8 gMainMenuDataModified;
 extern s8 gSaveFileModified;
 
 void save_file_do_save(s32 fileIndex);
+void save_file_update_eeprom(void);
+void save_file_flush_eeprom(void);
 void save_file_erase(s32 fileIndex);
 BAD_RETURN(s32) save_file_copy(s32 srcFileIndex, s32 destFileIndex);
 void save_file_load_all(void);
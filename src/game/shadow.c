@@ -106,6 +106,19 @@ s8 gMarioOnIceOrCarpet;
 s8 sMarioOnFlyingCarpet;
 s16 sSurfaceTypeBelowShadow;
 
+/**
+ * The floor under the shadow being created, found once by create_shadow_below_xyz
+ * and reused by the functions creating each type of shadow.
+ */
+static struct Surface *sShadowFloor;
+static f32 sShadowFloorHeight;
+static struct FloorGeometry sShadowFloorGeo;
+
+/**
+ * Height of the floor below each vertex of a 9 vertex shadow.
+ */
+static f32 sShadowVertexFloorY[9];
+
 /**
  * Let (oldZ, oldX) be the relative coordinates of a point on a rectangle,
  * assumed to be centered at the origin on the standard SM64 X-Z plane. This
@@ -192,6 +205,24 @@ f32 get_water_level_below_shadow(struct Shadow *s) {
 #endif
 }
 
+/**
+ * Return the height of the floor under the shadow being created, and point
+ * `floorGeo` to its geometry, like find_floor_height_and_data.
+ */
+static f32 get_floor_below_shadow(struct FloorGeometry **floorGeo) {
+    *floorGeo = NULL;
+
+    if (sShadowFloor != NULL) {
+        sShadowFloorGeo.normalX = sShadowFloor->normal.x;
+        sShadowFloorGeo.normalY = sShadowFloor->normal.y;
+        sShadowFloorGeo.normalZ = sShadowFloor->normal.z;
+        sShadowFloorGeo.originOffset = sShadowFloor->originOffset;
+
+        *floorGeo = &sShadowFloorGeo;
+    }
+    return sShadowFloorHeight;
+}
+
 /**
  * Initialize a shadow. Return 0 on success, 1 on failure.
  *
@@ -209,7 +240,7 @@ s8 init_shadow(struct Shadow *s, f32 xPos, f32 yPos, f32 zPos, s16 shadowScale,
     s->parentY = yPos;
     s->parentZ = zPos;
 
-    s->floorHeight = find_floor_height_and_data(s->parentX, s->parentY, s->parentZ, &floorGeometry);
+    s->floorHeight = get_floor_below_shadow(&floorGeometry);
 
     if (gEnvironmentRegions != NULL) {
         waterLevel = get_water_level_below_shadow(s);
@@ -345,6 +376,51 @@ void get_vertex_coords(s8 index, s8 shadowVertexType, s8 *xCoord, s8 *zCoord) {
     }
 }
 
+/**
+ * Populate `xPosVtx` and `zPosVtx` with the x and z position of the shadow
+ * vertex with the given index.
+ */
+void calculate_vertex_xz(s8 index, struct Shadow *s, f32 *xPosVtx, f32 *zPosVtx, s8 shadowVertexType) {
+    f32 tiltedScale = cosf(s->floorTilt * M_PI / 180.0) * s->shadowScale;
+    f32 downwardAngle = s->floorDownwardAngle * M_PI / 180.0;
+    f32 halfScale;
+    f32 halfTiltedScale;
+    s8 xCoordUnit;
+    s8 zCoordUnit;
+
+    // This makes xCoordUnit and yCoordUnit each one of -1, 0, or 1.
+    get_vertex_coords(index, shadowVertexType, &xCoordUnit, &zCoordUnit);
+
+    halfScale = (xCoordUnit * s->shadowScale) / 2.0;
+    halfTiltedScale = (zCoordUnit * tiltedScale) / 2.0;
+
+    *xPosVtx = (halfTiltedScale * sinf(downwardAngle)) + (halfScale * cosf(downwardAngle)) + s->parentX;
+    *zPosVtx = (halfTiltedScale * cosf(downwardAngle)) - (halfScale * sinf(downwardAngle)) + s->parentZ;
+}
+
+/**
+ * Find the height of the floor below each vertex of a 9 vertex shadow, which
+ * `calculate_vertex_xyz` clamps the vertices to. The vertices are all checked
+ * together, and the center one is right above the floor under the shadow.
+ */
+void find_shadow_vertex_floors(struct Shadow *s) {
+    f32 xPos[8];
+    f32 zPos[8];
+    f32 heights[8];
+    s32 i;
+
+    for (i = 0; i < 8; i++) {
+        calculate_vertex_xz(i < 4 ? i : i + 1, s, &xPos[i], &zPos[i], SHADOW_WITH_9_VERTS);
+    }
+
+    find_floor_heights(xPos, s->parentY, zPos, 8, heights);
+
+    for (i = 0; i < 8; i++) {
+        sShadowVertexFloorY[i < 4 ? i : i + 1] = heights[i];
+    }
+    sShadowVertexFloorY[4] = sShadowFloorHeight;
+}
+
 /**
  * Populate `xPosVtx`, `yPosVtx`, and `zPosVtx` with the (x, y, z) position of the
  * shadow vertex with the given index. If the shadow is to have 9 vertices,
@@ -358,22 +434,7 @@ void get_vertex_coords(s8 index, s8 shadowVertexType, s8 *xCoord, s8 *zCoord) {
  */
 void calculate_vertex_xyz(s8 index, struct Shadow s, f32 *xPosVtx, f32 *yPosVtx, f32 *zPosVtx,
                           s8 shadowVertexType) {
-    f32 tiltedScale = cosf(s.floorTilt * M_PI / 180.0) * s.shadowScale;
-    f32 downwardAngle = s.floorDownwardAngle * M_PI / 180.0;
-    f32 halfScale;
-    f32 halfTiltedScale;
-    s8 xCoordUnit;
-    s8 zCoordUnit;
-    struct FloorGeometry *dummy;
-
-    // This makes xCoordUnit and yCoordUnit each one of -1, 0, or 1.
-    get_vertex_coords(index, shadowVertexType, &xCoordUnit, &zCoordUnit);
-
-    halfScale = (xCoordUnit * s.shadowScale) / 2.0;
-    halfTiltedScale = (zCoordUnit * tiltedScale) / 2.0;
-
-    *xPosVtx = (halfTiltedScale * sinf(downwardAngle)) + (halfScale * cosf(downwardAngle)) + s.parentX;
-    *zPosVtx = (halfTiltedScale * cosf(downwardAngle)) - (halfScale * sinf(downwardAngle)) + s.parentZ;
+    calculate_vertex_xz(index, &s, xPosVtx, zPosVtx, shadowVertexType);
 
     if (gShadowAboveWaterOrLava) {
         *yPosVtx = s.floorHeight;
@@ -386,8 +447,8 @@ void calculate_vertex_xyz(s8 index, struct Shadow s, f32 *xPosVtx, f32 *yPosVtx,
             case SHADOW_WITH_9_VERTS:
                 // Clamp this vertex's y-position to that of the floor directly
                 // below it, which may differ from the floor below the center
-                // vertex.
-                *yPosVtx = find_floor_height_and_data(*xPosVtx, s.parentY, *zPosVtx, &dummy);
+                // vertex. See find_shadow_vertex_floors.
+                *yPosVtx = sShadowVertexFloorY[index];
                 break;
             case SHADOW_WITH_4_VERTS:
                 // Do not clamp. Instead, extrapolate the y-position of this
@@ -633,6 +694,10 @@ Gfx *create_shadow_player(f32 xPos, f32 yPos, f32 zPos, s16 shadowScale, u8 soli
 
     correct_lava_shadow_height(&shadow);
 
+    if (!gShadowAboveWaterOrLava) {
+        find_shadow_vertex_floors(&shadow);
+    }
+
     for (i = 0; i < 9; i++) {
         make_shadow_vertex(verts, i, shadow, SHADOW_WITH_9_VERTS);
     }
@@ -659,6 +724,11 @@ Gfx *create_shadow_circle_9_verts(f32 xPos, f32 yPos, f32 zPos, s16 shadowScale,
     if (verts == NULL || displayList == NULL) {
         return 0;
     }
+
+    if (!gShadowAboveWaterOrLava) {
+        find_shadow_vertex_floors(&shadow);
+    }
+
     for (i = 0; i < 9; i++) {
         make_shadow_vertex(verts, i, shadow, SHADOW_WITH_9_VERTS);
     }
@@ -697,13 +767,13 @@ Gfx *create_shadow_circle_4_verts(f32 xPos, f32 yPos, f32 zPos, s16 shadowScale,
  * Create a circular shadow composed of 4 vertices and assume that the ground
  * underneath it is totally flat.
  */
-Gfx *create_shadow_circle_assuming_flat_ground(f32 xPos, f32 yPos, f32 zPos, s16 shadowScale,
-                                               u8 solidity) {
+Gfx *create_shadow_circle_assuming_flat_ground(UNUSED f32 xPos, f32 yPos, UNUSED f32 zPos,
+                                               s16 shadowScale, u8 solidity) {
     Vtx *verts;
     Gfx *displayList;
-    struct FloorGeometry *dummy; // only for calling find_floor_height_and_data
+    struct FloorGeometry *dummy; // only for calling get_floor_below_shadow
     f32 distBelowFloor;
-    f32 floorHeight = find_floor_height_and_data(xPos, yPos, zPos, &dummy);
+    f32 floorHeight = get_floor_below_shadow(&dummy);
     f32 radius = shadowScale / 2;
 
     if (floorHeight < FLOOR_LOWER_LIMIT_SHADOW) {
@@ -763,7 +833,7 @@ Gfx *create_shadow_rectangle(f32 halfWidth, f32 halfLength, f32 relY, u8 solidit
 s32 get_shadow_height_solidity(f32 xPos, f32 yPos, f32 zPos, f32 *shadowHeight, u8 *solidity) {
     struct FloorGeometry *dummy;
     f32 waterLevel;
-    *shadowHeight = find_floor_height_and_data(xPos, yPos, zPos, &dummy);
+    *shadowHeight = get_floor_below_shadow(&dummy);
 
     if (*shadowHeight < FLOOR_LOWER_LIMIT_SHADOW) {
         return 1;
@@ -853,7 +923,8 @@ Gfx *create_shadow_below_xyz(f32 xPos, f32 yPos, f32 zPos, s16 shadowScale, u8 s
                              s8 shadowType) {
     Gfx *displayList = NULL;
     struct Surface *pfloor;
-    find_floor(xPos, yPos, zPos, &pfloor);
+    sShadowFloorHeight = find_floor(xPos, yPos, zPos, &pfloor);
+    sShadowFloor = pfloor;
 
     gShadowAboveWaterOrLava = FALSE;
     gMarioOnIceOrCarpet = 0;
@@ -349,7 +349,9 @@ void thread4_sound(UNUSED void *arg) {
         if (gResetTimer < 25) {
             struct SPTask *spTask;
             profiler_log_thread4_time();
+            PROFILER_ZONE_BEGIN(PROFILER_ZONE_AUDIO);
             spTask = create_next_audio_frame_task();
+            PROFILER_ZONE_END(PROFILER_ZONE_AUDIO);
             if (spTask != NULL) {
                 dispatch_audio_sptask(spTask);
             }
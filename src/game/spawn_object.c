@@ -126,6 +126,190 @@ static void deallocate_object(struct ObjectNode *freeList, struct ObjectNode *ob
     freeList->next = obj;
 }
 
+/**
+ * Index from each behavior to the objects that currently have it, so that
+ * searches for a behavior don't have to walk a whole object list. The objects
+ * of a behavior are chained in spawn order, which is also their order within
+ * any one object list, so searches visit them in the same order as before.
+ * Behaviors stay in the table after their last object unloads; once it fills
+ * up, it is rebuilt from the loaded objects.
+ */
+#define BEHAVIOR_INDEX_SIZE 512 // must be a power of two
+#define BEHAVIOR_INDEX_MAX_USED 384
+#define BEHAVIOR_INDEX_NONE -1
+
+struct BehaviorIndexEntry {
+    const BehaviorScript *behavior;
+    s16 head;
+    s16 tail;
+};
+
+static struct BehaviorIndexEntry sBehaviorIndex[BEHAVIOR_INDEX_SIZE];
+static s32 sBehaviorIndexUsed;
+static u32 sObjectSpawnCount;
+
+// per object pool slot
+static s16 sBehaviorIndexNext[OBJECT_POOL_CAPACITY];
+static s16 sBehaviorIndexPrev[OBJECT_POOL_CAPACITY];
+static u32 sObjectSpawnOrder[OBJECT_POOL_CAPACITY];
+static u8 sObjectListIndex[OBJECT_POOL_CAPACITY];
+static u8 sObjectIndexed[OBJECT_POOL_CAPACITY];
+
+static void behavior_index_insert(struct Object *obj);
+
+static void behavior_index_rebuild(void) {
+    s32 i;
+
+    for (i = 0; i < BEHAVIOR_INDEX_SIZE; i++) {
+        sBehaviorIndex[i].behavior = NULL;
+    }
+    sBehaviorIndexUsed = 0;
+
+    for (i = 0; i < OBJECT_POOL_CAPACITY; i++) {
+        if (sObjectIndexed[i]) {
+            behavior_index_insert(&gObjectPool[i]);
+        }
+    }
+}
+
+/**
+ * Find the index entry for a behavior. If it isn't in the table, add it when
+ * create is set and return NULL otherwise.
+ */
+static struct BehaviorIndexEntry *behavior_index_find(const BehaviorScript *behavior, s32 create) {
+    struct BehaviorIndexEntry *entry;
+    u32 i = ((uintptr_t) behavior >> 2) & (BEHAVIOR_INDEX_SIZE - 1);
+
+    while (TRUE) {
+        entry = &sBehaviorIndex[i];
+
+        if (entry->behavior == behavior) {
+            return entry;
+        }
+
+        if (entry->behavior == NULL) {
+            if (!create) {
+                return NULL;
+            }
+
+            if (sBehaviorIndexUsed >= BEHAVIOR_INDEX_MAX_USED) {
+                // There are fewer behaviors loaded than the pool has objects,
+                // so this leaves plenty of room
+                behavior_index_rebuild();
+                return behavior_index_find(behavior, create);
+            }
+
+            sBehaviorIndexUsed++;
+            entry->behavior = behavior;
+            entry->head = BEHAVIOR_INDEX_NONE;
+            entry->tail = BEHAVIOR_INDEX_NONE;
+            return entry;
+        }
+
+        i = (i + 1) & (BEHAVIOR_INDEX_SIZE - 1);
+    }
+}
+
+static void behavior_index_insert(struct Object *obj) {
+    s32 slot = obj - gObjectPool;
+    struct BehaviorIndexEntry *entry = behavior_index_find(obj->behavior, TRUE);
+    s32 prev = entry->tail;
+    s32 next;
+
+    // Objects are normally added in spawn order, unless their behavior changed
+    while (prev != BEHAVIOR_INDEX_NONE && sObjectSpawnOrder[prev] > sObjectSpawnOrder[slot]) {
+        prev = sBehaviorIndexPrev[prev];
+    }
+
+    if (prev == BEHAVIOR_INDEX_NONE) {
+        next = entry->head;
+        entry->head = slot;
+    } else {
+        next = sBehaviorIndexNext[prev];
+        sBehaviorIndexNext[prev] = slot;
+    }
+
+    if (next == BEHAVIOR_INDEX_NONE) {
+        entry->tail = slot;
+    } else {
+        sBehaviorIndexPrev[next] = slot;
+    }
+
+    sBehaviorIndexPrev[slot] = prev;
+    sBehaviorIndexNext[slot] = next;
+    sObjectIndexed[slot] = TRUE;
+}
+
+static void behavior_index_remove(struct Object *obj) {
+    s32 slot = obj - gObjectPool;
+    struct BehaviorIndexEntry *entry;
+    s32 prev = sBehaviorIndexPrev[slot];
+    s32 next = sBehaviorIndexNext[slot];
+
+    if (!sObjectIndexed[slot]) {
+        return;
+    }
+
+    entry = behavior_index_find(obj->behavior, FALSE);
+
+    if (prev == BEHAVIOR_INDEX_NONE) {
+        entry->head = next;
+    } else {
+        sBehaviorIndexNext[prev] = next;
+    }
+
+    if (next == BEHAVIOR_INDEX_NONE) {
+        entry->tail = prev;
+    } else {
+        sBehaviorIndexPrev[next] = prev;
+    }
+
+    sObjectIndexed[slot] = FALSE;
+}
+
+static struct Object *behavior_index_skip_to_list(s32 slot, u32 objList) {
+    while (slot != BEHAVIOR_INDEX_NONE && sObjectListIndex[slot] != objList) {
+        slot = sBehaviorIndexNext[slot];
+    }
+
+    return slot == BEHAVIOR_INDEX_NONE ? NULL : &gObjectPool[slot];
+}
+
+/**
+ * Return the first object in objList whose behavior is the given virtual
+ * address, or NULL if there is none. Objects are visited in list order.
+ */
+struct Object *find_first_object_with_behavior(const BehaviorScript *behavior, u32 objList) {
+    struct BehaviorIndexEntry *entry = behavior_index_find(behavior, FALSE);
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return behavior_index_skip_to_list(entry->head, objList);
+}
+
+/**
+ * Return the object after obj in objList that has the same behavior, or NULL.
+ */
+struct Object *find_next_object_with_behavior(struct Object *obj, u32 objList) {
+    return behavior_index_skip_to_list(sBehaviorIndexNext[obj - gObjectPool], objList);
+}
+
+/**
+ * Change the behavior of a loaded object, keeping the behavior index in sync.
+ */
+void set_object_behavior(struct Object *obj, const BehaviorScript *behavior) {
+    if (sObjectIndexed[obj - gObjectPool]) {
+        behavior_index_remove(obj);
+        obj->behavior = behavior;
+        behavior_index_insert(obj);
+    } else {
+        // already unloaded
+        obj->behavior = behavior;
+    }
+}
+
 /**
  * Add every object in the pool to the free object list.
  */
@@ -145,6 +329,12 @@ void init_free_object_list(void) {
 
     // End the list
     obj->header.next = NULL;
+
+    // All objects are unloaded, so the behavior index starts out empty
+    for (i = 0; i < OBJECT_POOL_CAPACITY; i++) {
+        sObjectIndexed[i] = FALSE;
+    }
+    behavior_index_rebuild();
 }
 
 /**
@@ -197,6 +387,7 @@ void unload_object(struct Object *obj) {
     obj->header.gfx.node.flags &= ~GRAPH_RENDER_BILLBOARD;
     obj->header.gfx.node.flags &= ~GRAPH_RENDER_ACTIVE;
 
+    behavior_index_remove(obj);
     deallocate_object(&gFreeObjectList, &obj->header);
 }
 
@@ -330,6 +521,10 @@ struct Object *create_object(const BehaviorScript *bhvScript) {
     obj->curBhvCommand = bhvScript;
     obj->behavior = behavior;
 
+    sObjectListIndex[obj - gObjectPool] = objListIndex;
+    sObjectSpawnOrder[obj - gObjectPool] = sObjectSpawnCount++;
+    behavior_index_insert(obj);
+
     if (objListIndex == OBJ_LIST_UNIMPORTANT) {
         obj->activeFlags |= ACTIVE_FLAG_UNIMPORTANT;
     }
@@ -8,5 +8,8 @@ void clear_object_lists(struct ObjectNode *objLists);
 void unload_object(struct Object *obj);
 struct Object *create_object(const BehaviorScript *bhvScript);
 void mark_obj_for_deletion(struct Object *obj);
+struct Object *find_first_object_with_behavior(const BehaviorScript *behavior, u32 objList);
+struct Object *find_next_object_with_behavior(struct Object *obj, u32 objList);
+void set_object_behavior(struct Object *obj, const BehaviorScript *behavior);
 
 #endif // SPAWN_OBJECT_H
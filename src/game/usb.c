@@ -7,6 +7,7 @@
 #include "object_list_processor.h"
 #include "sm64.h"
 #include "print.h"
+#include "profiler.h"
 
 f32 read_usb_posX = -1629.98;
 f32 read_usb_posY = 261.04;
@@ -42,6 +43,36 @@ void string_copy(const char *src, int len, char *dest) {
     }
 }
 
+#if PROFILER_ZONES
+static u32 sProfilerUsbEventCount = 0;
+
+// copy the zone events logged since the last call to the cart SRAM ring, then
+// publish the new count so the host only reads complete events
+static void usb_write_profiler_events(void) {
+    struct ProfilerZoneEvent event;
+    u32 *words = (u32 *) &event;
+    u32 addr;
+    u32 stat;
+    s32 i;
+
+    for (i = 0; i < PROFILER_USB_RING_SIZE && profiler_pop_zone_event(&event); i++) {
+        addr = PROFILER_USB_RING_ADDR
+               + (sProfilerUsbEventCount % PROFILER_USB_RING_SIZE) * sizeof(struct ProfilerZoneEvent);
+
+        WAIT_ON_IO_BUSY(stat);
+        IO_WRITE(addr, words[0]);
+
+        WAIT_ON_IO_BUSY(stat);
+        IO_WRITE(addr + 4, words[1]);
+
+        sProfilerUsbEventCount++;
+    }
+
+    WAIT_ON_IO_BUSY(stat);
+    IO_WRITE(PROFILER_USB_COUNT_ADDR, sProfilerUsbEventCount);
+}
+#endif
+
 void incoming_usb_pos(f32 *x, f32 *y, f32 *z) {
     incomingUsbInterrupt = __osDisableInt();
     *x = read_usb_posX;
@@ -69,6 +100,8 @@ void thread7_usb_loop(UNUSED void *arg) {
 
     while (TRUE) {
         if (gMarioObject != NULL) {
+            PROFILER_ZONE_BEGIN(PROFILER_ZONE_USB);
+
             // this is casting the f32 binary values into the int by telling the compiler it's actually
             // a float this means we can pass the f32 as a u32 and convert it back at the other end
             *(f32 *) &posX_f32_binary_cast = __osAtomicReadF32(&gMarioObject->oPosX);
@@ -124,6 +157,13 @@ void thread7_usb_loop(UNUSED void *arg) {
             __osPiRelAccess();
  
             __osRestoreInt(prevInt);//END DISABLE INTERRUPTS
+            PROFILER_ZONE_END(PROFILER_ZONE_USB);
+
+#if PROFILER_ZONES
+            __osPiGetAccess();
+            usb_write_profiler_events();
+            __osPiRelAccess();
+#endif
 
             osSetTimer(&timer, OS_USEC_TO_CYCLES(5000), 0, mq, NULL);
             osRecvMesg(mq, &timerMsg, OS_MESG_BLOCK);
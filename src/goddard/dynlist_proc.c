@@ -32,6 +32,8 @@
 #define DYNOBJ_LIST_SIZE 3000
 /// Maximum number of verticies supported when adding vertices node to an `ObjShape`
 #define VTX_BUF_SIZE 3000
+/// Number of slots in the dynamic object name hash table (power of two, larger than `DYNOBJ_LIST_SIZE`)
+#define DYNOBJ_HASH_SIZE 4096
 
 // types
 /// Information about a dynamically created `GdObj`
@@ -62,6 +64,7 @@ struct DynObjInfo {
 
 // data
 static struct DynObjInfo *sGdDynObjList = NULL; // @ 801A8250; info for all loaded/made dynobjs
+static s16 *sGdDynObjHash = NULL; ///< open addressed table of `sGdDynObjList` index + 1, keyed by name
 static struct GdObj *sDynListCurObj = NULL;     // @ 801A8254
 static struct GdBoundingBox sNullBoundingBox = {        // @ 801A8258
     0.0, 0.0, 0.0,
@@ -146,6 +149,7 @@ void reset_dynlist(void) {
     sLoadedDynObjs = 0;
     sDynNameSuffix[0] = '\0';
     sGdDynObjList = NULL;
+    sGdDynObjHash = NULL;
     sDynListCurObj = NULL;
     sDynNetCount = 0;
     sUseIntegerNames = FALSE;
@@ -392,6 +396,20 @@ static void unstash_name_suffix(void) {
     gd_strcpy(sDynNameSuffix, sStashedDynNameSuffix);
 }
 
+/**
+ * Hash a full dynamic object name (including its suffix) into a starting
+ * slot of `sGdDynObjHash`.
+ */
+static u32 hash_dynobj_name(const char *str) {
+    u32 hash = 2166136261U;
+
+    while (*str != '\0') {
+        hash = (hash ^ (u8) *str++) * 16777619U;
+    }
+
+    return hash & (DYNOBJ_HASH_SIZE - 1);
+}
+
 /**
  * Get the `DynObjInfo` struct for object `name`
  *
@@ -415,9 +433,11 @@ static struct DynObjInfo *get_dynobj_info(DynObjName name) {
 
     gd_strcat(buf, sDynNameSuffix);
     foundDynobj = NULL;
-    for (i = 0; i < sLoadedDynObjs; i++) {
-        if (gd_str_not_equal(sGdDynObjList[i].name, buf) == 0) {
-            foundDynobj = &sGdDynObjList[i];
+    // Entries are never removed and duplicates are probed past, so the first
+    // match along the probe sequence is the earliest object with this name.
+    for (i = hash_dynobj_name(buf); sGdDynObjHash[i] != 0; i = (i + 1) & (DYNOBJ_HASH_SIZE - 1)) {
+        if (gd_str_not_equal(sGdDynObjList[sGdDynObjHash[i] - 1].name, buf) == 0) {
+            foundDynobj = &sGdDynObjList[sGdDynObjHash[i] - 1];
             break;
         }
     }
@@ -440,8 +460,10 @@ void reset_dynamic_objs(void) {
     }
 
     gd_free(sGdDynObjList);
+    gd_free(sGdDynObjHash);
     sLoadedDynObjs = 0;
     sGdDynObjList = NULL;
+    sGdDynObjHash = NULL;
 }
 
 /**
@@ -532,14 +554,19 @@ void d_make_netfromshape_ptrptr(struct ObjShape **shapePtr) {
 void add_to_dynobj_list(struct GdObj *newobj, DynObjName name) {
     UNUSED u8 filler[4];
     char idbuf[0x100];
+    u32 slot;
 
     start_memtracker("dynlist");
 
     if (sGdDynObjList == NULL) {
         sGdDynObjList = gd_malloc_temp(DYNOBJ_LIST_SIZE * sizeof(struct DynObjInfo));
-        if (sGdDynObjList == NULL) {
+        sGdDynObjHash = gd_malloc_temp(DYNOBJ_HASH_SIZE * sizeof(s16));
+        if (sGdDynObjList == NULL || sGdDynObjHash == NULL) {
             fatal_printf("dMakeObj(): Cant allocate dynlist memory");
         }
+        for (slot = 0; slot < DYNOBJ_HASH_SIZE; slot++) {
+            sGdDynObjHash[slot] = 0;
+        }
     }
 
     stop_memtracker("dynlist");
@@ -566,6 +593,12 @@ void add_to_dynobj_list(struct GdObj *newobj, DynObjName name) {
         fatal_printf("dyn list obj name too long '%s'", sGdDynObjList[sLoadedDynObjs].name);
     }
 
+    slot = hash_dynobj_name(sGdDynObjList[sLoadedDynObjs].name);
+    while (sGdDynObjHash[slot] != 0) {
+        slot = (slot + 1) & (DYNOBJ_HASH_SIZE - 1);
+    }
+    sGdDynObjHash[slot] = sLoadedDynObjs + 1;
+
     sGdDynObjList[sLoadedDynObjs].num = sLoadedDynObjs;
     sDynListCurInfo = &sGdDynObjList[sLoadedDynObjs];
     sGdDynObjList[sLoadedDynObjs++].obj = newobj;
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# Lists the most expensive behaviors from a RAM dump of a game built with
+# PROFILER_BEHAVIORS, using the linker map to find gProfilerBehaviorDump and to
+# name the behavior scripts.
+import sys
+import re
+import struct
+import bisect
+
+PROFILER_BEHAVIOR_MAGIC = 0x42485650
+RAM_BASE = 0x80000000
+# osGetCount ticks at 46.875 MHz
+COUNT_RATE = 46875000
+
+
+def read_map(filename):
+    symbols = {}
+    with open(filename, "r") as f:
+        for line in f:
+            m = re.match(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$", line)
+            if m:
+                symbols[m.group(2)] = int(m.group(1), 16) & 0xFFFFFFFF
+    return symbols
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: {} <ram dump> <sm64.map>".format(sys.argv[0]))
+        print("The RAM dump is big-endian RDRAM starting at 0x80000000.")
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        ram = f.read()
+    symbols = read_map(sys.argv[2])
+
+    def read_u32(addr):
+        off = addr - RAM_BASE
+        return struct.unpack(">I", ram[off : off + 4])[0]
+
+    for name in ["gProfilerBehaviorDump", "sSegmentTable"]:
+        if name not in symbols:
+            print("{} not found in map; was the game built with PROFILER_BEHAVIORS?".format(name))
+            sys.exit(1)
+
+    dump = symbols["gProfilerBehaviorDump"]
+    magic, sequence, frames, num_stats = struct.unpack(
+        ">IIII", ram[dump - RAM_BASE : dump - RAM_BASE + 16]
+    )
+    if magic != PROFILER_BEHAVIOR_MAGIC or frames == 0:
+        print("no behavior stats published in this dump")
+        sys.exit(1)
+
+    # behavior pointers are virtual addresses into segment 0x13
+    behavior_base = read_u32(symbols["sSegmentTable"] + 0x13 * 4) | RAM_BASE
+    behaviors = sorted(
+        (addr, name) for name, addr in symbols.items() if addr >> 24 == 0x13
+    )
+    behavior_addrs = [addr for addr, _ in behaviors]
+
+    def behavior_name(ptr):
+        seg_addr = 0x13000000 + ptr - behavior_base
+        i = bisect.bisect_right(behavior_addrs, seg_addr) - 1
+        if i < 0:
+            return "0x%08X" % ptr
+        addr, name = behaviors[i]
+        return name if addr == seg_addr else "%s+0x%X" % (name, seg_addr - addr)
+
+    def usec(cycles):
+        return cycles * 1000000 / COUNT_RATE
+
+    print("window #%d, %d frames" % (sequence, frames))
+    print("%-36s %8s %12s %10s %10s" % ("behavior", "calls", "us/frame", "mean us", "max us"))
+    for i in range(num_stats):
+        off = dump - RAM_BASE + 16 + i * 16
+        ptr, count, total, max_cycles = struct.unpack(">IIII", ram[off : off + 16])
+        print(
+            "%-36s %8d %12.1f %10.1f %10.1f"
+            % (
+                behavior_name(ptr),
+                count,
+                usec(total) / frames,
+                usec(total) / max(count, 1),
+                usec(max_cycles),
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,373 @@
+/* f3d_stats: estimate the RSP/RDP cost of a frame from an RDRAM dump
+ *
+ * Walks a Fast3D (or F3DEX with -x) display list inside a dump of RDRAM,
+ * following sub display lists through the game's segment table, and prints
+ * a JSON report with vertex, triangle, texture load and state change counts,
+ * broken down per render mode (which corresponds to the master list layers).
+ *
+ * The dump is taken from an emulator at any point during gameplay; the last
+ * submitted frame stays intact in one of gGfxPools until it is overwritten
+ * two frames later. The addresses of sSegmentTable and gGfxPools can be found
+ * in build/<VERSION>/sm64.<VERSION>.map.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RDRAM_MASK 0x1FFFFFFF
+#define DL_STACK_SIZE 10
+#define MAX_LAYERS 16
+#define MAX_COMMANDS 0x100000
+
+// Fast3D opcodes shared by F3D and F3DEX
+#define G_SPNOOP 0x00
+#define G_MTX 0x01
+#define G_MOVEMEM 0x03
+#define G_VTX 0x04
+#define G_DL 0x06
+#define G_TRI1 0xBF
+#define G_CULLDL 0xBE
+#define G_POPMTX 0xBD
+#define G_MOVEWORD 0xBC
+#define G_TEXTURE 0xBB
+#define G_SETOTHERMODE_H 0xBA
+#define G_SETOTHERMODE_L 0xB9
+#define G_ENDDL 0xB8
+#define G_SETGEOMETRYMODE 0xB7
+#define G_CLEARGEOMETRYMODE 0xB6
+#define G_QUAD 0xB5 // F3DEX only
+#define G_TRI2 0xB1 // F3DEX only
+#define G_TEXRECT 0xE4
+#define G_TEXRECTFLIP 0xE5
+#define G_RDPLOADSYNC 0xE6
+#define G_RDPPIPESYNC 0xE7
+#define G_RDPTILESYNC 0xE8
+#define G_RDPFULLSYNC 0xE9
+#define G_SETSCISSOR 0xED
+#define G_RDPSETOTHERMODE 0xEF
+#define G_LOADTLUT 0xF0
+#define G_SETTILESIZE 0xF2
+#define G_LOADBLOCK 0xF3
+#define G_LOADTILE 0xF4
+#define G_SETTILE 0xF5
+#define G_FILLRECT 0xF6
+#define G_SETFILLCOLOR 0xF7
+#define G_SETFOGCOLOR 0xF8
+#define G_SETBLENDCOLOR 0xF9
+#define G_SETPRIMCOLOR 0xFA
+#define G_SETENVCOLOR 0xFB
+#define G_SETCOMBINE 0xFC
+#define G_SETTIMG 0xFD
+#define G_SETZIMG 0xFE
+#define G_SETCIMG 0xFF
+
+// G_SETOTHERMODE_L shift of the render mode bits
+#define G_MDSFT_RENDERMODE 3
+
+// offset of data_ptr in OSTask
+#define OSTASK_DATA_PTR 0x30
+
+typedef struct {
+    uint32_t renderMode;
+    unsigned int commands;
+    unsigned int dlCalls;
+    unsigned int matrices;
+    unsigned int vertices;
+    unsigned int triangles;
+    unsigned int textureLoads;
+    unsigned int stateChanges;
+    unsigned int syncs;
+    unsigned long rectPixels;
+} Stats;
+
+static uint8_t *sRdram;
+static size_t sRdramSize;
+static bool sWordSwapped = false;
+static bool sF3dex = false;
+static uint32_t sSegments[16];
+
+static Stats sTotal;
+static Stats sLayers[MAX_LAYERS];
+static int sNumLayers = 0;
+static Stats *sCurLayer = NULL;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-x] [-w] RDRAM_DUMP SEGMENT_TABLE_ADDR (DL_ADDR | -t TASK_ADDR)\n"
+            "\n"
+            "Prints display list statistics for one frame as JSON.\n"
+            "  -x   the ROM was built with GRUCODE=f3dex\n"
+            "  -w   the dump stores 32-bit words in little-endian order\n"
+            "  -t   read the display list address from the OSTask at TASK_ADDR\n"
+            "       (the spTask member of a gGfxPools entry)\n",
+            prog);
+    exit(1);
+}
+
+static uint32_t read_u32(uint32_t addr) {
+    const uint8_t *p;
+
+    addr &= RDRAM_MASK;
+    if (addr & 3 || addr + 4 > sRdramSize) {
+        fprintf(stderr, "error: read outside of RDRAM at 0x%08X\n", addr);
+        exit(1);
+    }
+    p = &sRdram[addr];
+    if (sWordSwapped) {
+        return (uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 | (uint32_t) p[1] << 8 | p[0];
+    }
+    return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+}
+
+static uint32_t segmented_to_physical(uint32_t addr) {
+    return (sSegments[(addr >> 24) & 0xF] + (addr & 0x00FFFFFF)) & RDRAM_MASK;
+}
+
+static Stats *layer_for_render_mode(uint32_t renderMode) {
+    int i;
+
+    for (i = 0; i < sNumLayers; i++) {
+        if (sLayers[i].renderMode == renderMode) {
+            return &sLayers[i];
+        }
+    }
+    if (sNumLayers == MAX_LAYERS) {
+        return &sLayers[MAX_LAYERS - 1];
+    }
+    sLayers[sNumLayers].renderMode = renderMode;
+    return &sLayers[sNumLayers++];
+}
+
+// rectangle coordinates are in 10.2 fixed point
+static unsigned long rect_pixels(uint32_t w0, uint32_t w1) {
+    long x1 = (w0 >> 12) & 0xFFF;
+    long y1 = w0 & 0xFFF;
+    long x0 = (w1 >> 12) & 0xFFF;
+    long y0 = w1 & 0xFFF;
+
+    if (x1 <= x0 || y1 <= y0) {
+        return 0;
+    }
+    return (unsigned long) (((x1 - x0) >> 2) + 1) * (unsigned long) (((y1 - y0) >> 2) + 1);
+}
+
+#define COUNT(field, n)                                                                            \
+    do {                                                                                           \
+        sTotal.field += (n);                                                                       \
+        if (sCurLayer != NULL) {                                                                   \
+            sCurLayer->field += (n);                                                               \
+        }                                                                                          \
+    } while (0)
+
+static void walk_display_list(uint32_t addr) {
+    uint32_t stack[DL_STACK_SIZE];
+    int depth = 0;
+    unsigned int executed = 0;
+
+    addr = segmented_to_physical(addr);
+    for (;;) {
+        uint32_t w0 = read_u32(addr);
+        uint32_t w1 = read_u32(addr + 4);
+        uint8_t op = w0 >> 24;
+
+        addr += 8;
+        if (++executed > MAX_COMMANDS) {
+            fprintf(stderr, "error: display list does not terminate\n");
+            exit(1);
+        }
+        COUNT(commands, 1);
+
+        switch (op) {
+            case G_MTX:
+                COUNT(matrices, 1);
+                break;
+            case G_VTX:
+                if (sF3dex) {
+                    COUNT(vertices, (w0 >> 10) & 0x3F);
+                } else {
+                    COUNT(vertices, ((w0 >> 20) & 0xF) + 1);
+                }
+                break;
+            case G_TRI1:
+                COUNT(triangles, 1);
+                break;
+            case G_TRI2:
+            case G_QUAD:
+                if (sF3dex) {
+                    COUNT(triangles, 2);
+                }
+                break;
+            case G_DL:
+                COUNT(dlCalls, 1);
+                if (((w0 >> 16) & 0xFF) == 0) {
+                    if (depth == DL_STACK_SIZE) {
+                        fprintf(stderr, "error: display list stack overflow\n");
+                        exit(1);
+                    }
+                    stack[depth++] = addr;
+                }
+                addr = segmented_to_physical(w1);
+                break;
+            case G_ENDDL:
+                if (depth == 0) {
+                    return;
+                }
+                addr = stack[--depth];
+                break;
+            case G_MOVEWORD:
+                // gSPSegment: index 6 is G_MW_SEGMENT, the offset holds segment * 4
+                if ((w0 & 0xFF) == 6) {
+                    sSegments[((w0 >> 8) & 0xFFFF) / 4 & 0xF] = w1 & RDRAM_MASK;
+                }
+                COUNT(stateChanges, 1);
+                break;
+            case G_SETOTHERMODE_L:
+                if (((w0 >> 8) & 0xFF) == G_MDSFT_RENDERMODE) {
+                    sCurLayer = layer_for_render_mode(w1);
+                }
+                COUNT(stateChanges, 1);
+                break;
+            case G_TEXTURE:
+            case G_SETOTHERMODE_H:
+            case G_SETGEOMETRYMODE:
+            case G_CLEARGEOMETRYMODE:
+            case G_RDPSETOTHERMODE:
+            case G_SETSCISSOR:
+            case G_SETTILE:
+            case G_SETTILESIZE:
+            case G_SETFILLCOLOR:
+            case G_SETFOGCOLOR:
+            case G_SETBLENDCOLOR:
+            case G_SETPRIMCOLOR:
+            case G_SETENVCOLOR:
+            case G_SETCOMBINE:
+            case G_SETTIMG:
+            case G_SETZIMG:
+            case G_SETCIMG:
+                COUNT(stateChanges, 1);
+                break;
+            case G_LOADTLUT:
+            case G_LOADBLOCK:
+            case G_LOADTILE:
+                COUNT(textureLoads, 1);
+                break;
+            case G_RDPLOADSYNC:
+            case G_RDPPIPESYNC:
+            case G_RDPTILESYNC:
+            case G_RDPFULLSYNC:
+                COUNT(syncs, 1);
+                break;
+            case G_FILLRECT:
+                COUNT(rectPixels, rect_pixels(w0, w1));
+                break;
+            case G_TEXRECT:
+            case G_TEXRECTFLIP:
+                COUNT(rectPixels, rect_pixels(w0, w1));
+                // the texture coordinates follow in two more commands
+                addr += 16;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void print_stats(const Stats *stats, const char *indent) {
+    printf("%s\"commands\": %u,\n", indent, stats->commands);
+    printf("%s\"dl_calls\": %u,\n", indent, stats->dlCalls);
+    printf("%s\"matrices\": %u,\n", indent, stats->matrices);
+    printf("%s\"vertices\": %u,\n", indent, stats->vertices);
+    printf("%s\"triangles\": %u,\n", indent, stats->triangles);
+    printf("%s\"texture_loads\": %u,\n", indent, stats->textureLoads);
+    printf("%s\"state_changes\": %u,\n", indent, stats->stateChanges);
+    printf("%s\"syncs\": %u,\n", indent, stats->syncs);
+    printf("%s\"rect_pixels\": %lu", indent, stats->rectPixels);
+}
+
+static uint32_t parse_addr(const char *str, const char *prog) {
+    char *end;
+    unsigned long value = strtoul(str, &end, 0);
+
+    if (*str == '\0' || *end != '\0') {
+        usage(prog);
+    }
+    return (uint32_t) value;
+}
+
+int main(int argc, char **argv) {
+    const char *prog = argv[0];
+    FILE *file;
+    long size;
+    uint32_t segmentTable;
+    uint32_t dlAddr;
+    int i;
+
+    while (argc > 1 && argv[1][0] == '-' && argv[1][1] != 't') {
+        if (strcmp(argv[1], "-x") == 0) {
+            sF3dex = true;
+        } else if (strcmp(argv[1], "-w") == 0) {
+            sWordSwapped = true;
+        } else {
+            usage(prog);
+        }
+        argc--;
+        argv++;
+    }
+    if (argc != 4 && argc != 5) {
+        usage(prog);
+    }
+
+    file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        fprintf(stderr, "error: could not open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    sRdram = malloc(size);
+    if (sRdram == NULL || fread(sRdram, 1, size, file) != (size_t) size) {
+        fprintf(stderr, "error: could not read %s\n", argv[1]);
+        return 1;
+    }
+    sRdramSize = size;
+    fclose(file);
+
+    segmentTable = parse_addr(argv[2], prog);
+    for (i = 0; i < 16; i++) {
+        sSegments[i] = read_u32(segmentTable + i * 4) & RDRAM_MASK;
+    }
+
+    if (argc == 5) {
+        if (strcmp(argv[3], "-t") != 0) {
+            usage(prog);
+        }
+        dlAddr = read_u32(parse_addr(argv[4], prog) + OSTASK_DATA_PTR);
+    } else {
+        dlAddr = parse_addr(argv[3], prog);
+    }
+
+    // the master display list itself is addressed physically
+    sSegments[0] = 0;
+    walk_display_list(dlAddr & RDRAM_MASK);
+
+    printf("{\n");
+    printf("  \"total\": {\n");
+    print_stats(&sTotal, "    ");
+    printf("\n  },\n");
+    printf("  \"layers\": [");
+    for (i = 0; i < sNumLayers; i++) {
+        printf("%s\n    {\n", i == 0 ? "" : ",");
+        printf("      \"render_mode\": \"0x%08X\",\n", sLayers[i].renderMode);
+        print_stats(&sLayers[i], "      ");
+        printf("\n    }");
+    }
+    printf("%s]\n", sNumLayers == 0 ? "" : "\n  ");
+    printf("}\n");
+
+    free(sRdram);
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include <cinttypes>
 #include <unistd.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -453,19 +454,29 @@ void add_function(uint32_t addr) {
     }
 }
 
+// Flat sorted copy of `functions` for find_function. Functions are only ever
+// added, so the index is rebuilt whenever the map has grown.
+static vector<pair<uint32_t, map<uint32_t, Function>::iterator>> function_index;
+
 map<uint32_t, Function>::iterator find_function(uint32_t addr) {
-    if (functions.size() == 0) {
-        return functions.end();
+    if (function_index.size() != functions.size()) {
+        function_index.clear();
+        function_index.reserve(functions.size());
+
+        for (auto it = functions.begin(); it != functions.end(); ++it) {
+            function_index.emplace_back(it->first, it);
+        }
     }
 
-    auto it = functions.upper_bound(addr);
+    auto it = upper_bound(function_index.begin(), function_index.end(), addr,
+                          [](uint32_t a, const auto& entry) { return a < entry.first; });
 
-    if (it == functions.begin()) {
+    if (it == function_index.begin()) {
         return functions.end();
     }
 
     --it;
-    return it;
+    return it->second;
 }
 
 rabbitizer::Registers::Cpu::GprO32 get_dest_reg(const Insn& insn) {
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Summarizes the profiler zone events streamed over USB when the game is
+# built with PROFILER_ZONES.
+#
+# The input is a capture of the events in the order they were written, as
+# 8-byte big-endian struct ProfilerZoneEvent records. The host side appends
+# each new event it reads from the cart SRAM ring (see include/usb.h).
+import sys
+import struct
+from collections import defaultdict
+
+# osGetCount runs at half the CPU clock
+COUNT_RATE = 46875000
+
+ZONE_NAMES = [
+    "level_script",
+    "objects",
+    "object_collision",
+    "graph",
+    "audio",
+    "usb",
+    "envfx",
+]
+
+EVENT_BEGIN = 0
+EVENT_END = 1
+
+
+def usec(counts):
+    return counts * 1000000 / COUNT_RATE
+
+
+def zone_name(zone):
+    return ZONE_NAMES[zone] if zone < len(ZONE_NAMES) else "zone%d" % zone
+
+
+def read_events(filename):
+    with open(filename, "rb") as f:
+        data = f.read()
+    events = []
+    for off in range(0, len(data) - 7, 8):
+        time, thread, zone, type, _ = struct.unpack(">IBBBB", data[off : off + 8])
+        events.append((time, thread, zone, type))
+    return events
+
+
+def process(events):
+    stacks = defaultdict(list)  # thread -> [(zone, start, child time)]
+    zone_times = defaultdict(list)  # zone -> inclusive durations
+    folded = defaultdict(int)  # stack -> self time
+    frame_starts = []
+    unmatched = 0
+
+    for time, thread, zone, type in events:
+        stack = stacks[thread]
+        if type == EVENT_BEGIN:
+            stack.append([zone, time, 0])
+            if zone == 0:
+                frame_starts.append(time)
+            continue
+
+        # close zones left open by dropped events
+        while stack and stack[-1][0] != zone:
+            stack.pop()
+            unmatched += 1
+        if not stack:
+            unmatched += 1
+            continue
+
+        zone, start, child = stack.pop()
+        duration = (time - start) & 0xFFFFFFFF
+        zone_times[zone].append(duration)
+        path = ";".join(
+            ["thread%d" % thread] + [zone_name(z) for z, _, _ in stack] + [zone_name(zone)]
+        )
+        folded[path] += duration - child
+        if stack:
+            stack[-1][2] += duration
+
+    frame_times = [
+        (b - a) & 0xFFFFFFFF for a, b in zip(frame_starts, frame_starts[1:])
+    ]
+    return zone_times, folded, frame_times, unmatched
+
+
+def print_summary(zone_times, frame_times, unmatched):
+    print("%-18s %8s %10s %10s %10s" % ("zone", "count", "total ms", "mean us", "max us"))
+    for zone in sorted(zone_times):
+        times = zone_times[zone]
+        print(
+            "%-18s %8d %10.2f %10.1f %10.1f"
+            % (
+                zone_name(zone),
+                len(times),
+                usec(sum(times)) / 1000,
+                usec(sum(times) / len(times)),
+                usec(max(times)),
+            )
+        )
+    if unmatched:
+        print("%d unmatched events (ring overflow?)" % unmatched)
+
+    if not frame_times:
+        return
+    print()
+    print("frame time histogram (level script start to start):")
+    buckets = defaultdict(int)
+    for t in frame_times:
+        buckets[int(usec(t) // 1000)] += 1
+    scale = max(buckets.values())
+    for ms in range(min(buckets), max(buckets) + 1):
+        count = buckets.get(ms, 0)
+        print("%3d-%3d ms %6d %s" % (ms, ms + 1, count, "#" * (count * 50 // scale)))
+
+
+def main():
+    args = sys.argv[1:]
+    if len(args) not in (1, 2) or (len(args) == 2 and args[0] != "--folded"):
+        print("Usage: {} [--folded] <capture.bin>".format(sys.argv[0]))
+        print("--folded prints collapsed stacks in microseconds for flamegraph.pl")
+        sys.exit(1)
+
+    zone_times, folded, frame_times, unmatched = process(read_events(args[-1]))
+    if args[0] == "--folded":
+        for path in sorted(folded):
+            print("%s %d" % (path, round(usec(folded[path]))))
+    else:
+        print_summary(zone_times, frame_times, unmatched)
+
+
+if __name__ == "__main__":
+    main()
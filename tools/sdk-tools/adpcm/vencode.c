@@ -23,7 +23,9 @@ void vencodeframe(FILE *ofile, s16 *inBuffer, s32 *state, s32 ***coefTable, s32
     s32 maxClip;
     u8 header;
     u8 c;
+    u8 frame[9];
     f32 e[16];
+    f32 bestE[16];
     f32 se;
     f32 min;
 
@@ -61,6 +63,19 @@ void vencodeframe(FILE *ofile, s16 *inBuffer, s32 *state, s32 ***coefTable, s32
             e[i] = (f32) inVector[i + order];
         }
 
+        // The squared errors only grow, so if the first 8 samples already
+        // reach the best norm so far, this predictor can't win.
+        se = 0.0f;
+        for (j = 0; j < 8; j++)
+        {
+            se += e[j] * e[j];
+        }
+
+        if (!(se < min))
+        {
+            continue;
+        }
+
         // For the next 8 samples, start with 'order' values from the end of
         // the previous 8-sample chunk of inBuffer. (The code is equivalent to
         // inVector[i] = inBuffer[8 - order + i].)
@@ -79,8 +94,7 @@ void vencodeframe(FILE *ofile, s16 *inBuffer, s32 *state, s32 ***coefTable, s32
 
         // Compute the L2 norm of the errors; the lowest norm decides which
         // predictor to use.
-        se = 0.0f;
-        for (j = 0; j < 16; j++)
+        for (j = 8; j < 16; j++)
         {
             se += e[j] * e[j];
         }
@@ -89,32 +103,18 @@ void vencodeframe(FILE *ofile, s16 *inBuffer, s32 *state, s32 ***coefTable, s32
         {
             min = se;
             optimalp = k;
+            for (j = 0; j < 16; j++)
+            {
+                bestE[j] = e[j];
+            }
         }
     }
 
-    // Do exactly the same thing again, for real.
-    for (i = 0; i < order; i++)
-    {
-        inVector[i] = state[16 - order + i];
-    }
-
-    for (i = 0; i < 8; i++)
-    {
-        prediction[i] = inner_product(order + i, coefTable[optimalp][i], inVector);
-        inVector[i + order] = inBuffer[i] - prediction[i];
-        e[i] = (f32) inVector[i + order];
-    }
-
-    for (i = 0; i < order; i++)
-    {
-        inVector[i] = prediction[8 - order + i] + inVector[8 + i];
-    }
-
-    for (i = 0; i < 8; i++)
+    // The original tool did exactly the same thing again for the chosen
+    // predictor here; its errors were saved above instead.
+    for (j = 0; j < 16; j++)
     {
-        prediction[8 + i] = inner_product(order + i, coefTable[optimalp][i], inVector);
-        inVector[i + order] = inBuffer[8 + i] - prediction[8 + i];
-        e[8 + i] = (f32) inVector[i + order];
+        e[j] = bestE[j];
     }
 
     // Clamp the errors to 16-bit signed ints, and put them in ie.
@@ -227,10 +227,11 @@ out:;
     // The scale, the predictor index, and the 16 computed outputs are now all
     // 4-bit numbers. Write them out as 1 + 8 bytes.
     header = (scale << 4) | (optimalp & 0xf);
-    fwrite(&header, 1, 1, ofile);
+    frame[0] = header;
     for (i = 0; i < 16; i += 2)
     {
         c = (ix[i] << 4) | (ix[i + 1] & 0xf);
-        fwrite(&c, 1, 1, ofile);
+        frame[1 + i / 2] = c;
     }
+    fwrite(frame, 1, 9, ofile);
 }
@@ -157,8 +157,13 @@ if "--print-end-padding" in sys.argv:
     print_end_padding = True
     sys.argv.remove("--print-end-padding")
 
+print_stats = False
+if "--print-stats" in sys.argv:
+    print_stats = True
+    sys.argv.remove("--print-stats")
+
 if len(sys.argv) != 2:
-    print(f"Usage: {sys.argv[0]} (--emit-asm-macros | input.m64)")
+    print(f"Usage: {sys.argv[0]} [--print-stats] (--emit-asm-macros | input.m64)")
     sys.exit(0)
 
 if sys.argv[1] == "--emit-asm-macros":
@@ -325,6 +330,7 @@ except Exception:
 
 output = [None] * len(data)
 output_instate = [None] * len(data)
+output_cmd = [None] * len(data)
 label_name = [None] * len(data)
 script_start = [False] * len(data)
 hit_eof = False
@@ -540,6 +546,7 @@ def decode_one(state):
         output[p] = ''
         output_instate[p] = state
     output[orig_pos] = out_all
+    output_cmd[orig_pos] = cmd_mn
 
     if cmd_mn in ['hang', 'jump']:
         return
@@ -569,6 +576,35 @@ def decode_rec(state, initial):
     while decode_list:
         decode_one(decode_list.pop())
 
+# Commands after which the sequence player stops parsing a script until the
+# next delay has elapsed.
+yield_cmds = {
+    'seq': ['delay', 'delay1', 'end', 'hang'],
+    'chan': ['delay', 'delay1', 'end', 'hang'],
+    'layer': ['delay', 'end', 'note0', 'note1', 'note2',
+              'smallnote0', 'smallnote1', 'smallnote2'],
+}
+
+def print_script_stats():
+    # Counts decoded commands per script type, and how many of them are
+    # points where the player yields. Their ratio is the number of commands
+    # parsed per script step, which bounds what pre-decoding could save.
+    counts = {}
+    for i in range(len(data)):
+        if output_cmd[i] is None:
+            continue
+        tp = output_instate[i][1].split('_')[0]
+        if tp not in yield_cmds:
+            continue
+        total, yields = counts.get(tp, (0, 0))
+        if output_cmd[i] in yield_cmds[tp]:
+            yields += 1
+        counts[tp] = (total + 1, yields)
+    for tp in ['seq', 'chan', 'layer']:
+        total, yields = counts.get(tp, (0, 0))
+        per_step = total / yields if yields else 0
+        print(f"{tp}: {total} commands, {yields} yield points, {per_step:.2f} commands per step")
+
 def main():
     decode_rec((0, 'seq', 0, False), initial=True)
 
@@ -719,6 +755,10 @@ def main():
         print(end_padding)
         sys.exit(0)
 
+    if print_stats:
+        print_script_stats()
+        sys.exit(0)
+
     print(".include \"seq_macros.inc\"")
     print(".section .rodata")
     print(".align 0")
@@ -18,43 +18,39 @@
 // types
 typedef struct
 {
-   int *indexes;
-   int allocated;
-   int count;
-   int start;
-} lookback;
+   const unsigned char *buf;
+   int *head;
+   int *prev;
+   int inserted;
+} match_finder;
 
 // functions
-#define LOOKBACK_COUNT 256
-#define LOOKBACK_INIT_SIZE 128
-static lookback *lookback_init(void)
+#define WINDOW_SIZE 4096
+#define MAX_MATCH 18
+#define MIN_MATCH 3
+#define HASH_BITS 15
+#define HASH_SIZE (1 << HASH_BITS)
+
+static inline unsigned int hash3(const unsigned char *p)
 {
-   lookback *lb = malloc(LOOKBACK_COUNT * sizeof(*lb));
-   for (int i = 0; i < LOOKBACK_COUNT; i++) {
-      lb[i].allocated = LOOKBACK_INIT_SIZE;
-      lb[i].indexes = malloc(lb[i].allocated * sizeof(*lb[i].indexes));
-      lb[i].count = 0;
-      lb[i].start = 0;
-   }
-   return lb;
+   return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761u) >> (32 - HASH_BITS);
 }
 
-static void lookback_free(lookback *lb)
+static void match_finder_init(match_finder *mf, const unsigned char *buf, int length)
 {
-   for (int i = 0; i < LOOKBACK_COUNT; i++) {
-      free(lb[i].indexes);
+   mf->buf = buf;
+   mf->head = malloc(HASH_SIZE * sizeof(*mf->head));
+   mf->prev = malloc(MAX(length, 1) * sizeof(*mf->prev));
+   mf->inserted = 0;
+   for (int i = 0; i < HASH_SIZE; i++) {
+      mf->head[i] = -1;
    }
-   free(lb);
 }
 
-static inline void lookback_push(lookback *lkbk, unsigned char val, int index)
+static void match_finder_free(match_finder *mf)
 {
-   lookback *lb = &lkbk[val];
-   if (lb->count == lb->allocated) {
-      lb->allocated *= 4;
-      lb->indexes = realloc(lb->indexes, lb->allocated * sizeof(*lb->indexes));
-   }
-   lb->indexes[lb->count++] = index;
+   free(mf->head);
+   free(mf->prev);
 }
 
 static void PUT_BIT(unsigned char *buf, int bit, int val)
@@ -65,21 +61,24 @@ static void PUT_BIT(unsigned char *buf, int bit, int val)
 }
 
 // used to find longest matching stream in buffer
-// buf: buffer
+// mf: match finder over buffer
 // start_offset: offset in buf to look back from
 // max_search: max number of bytes to find
 // found_offset: returned offset found (0 if none found)
-// returns max length of matching stream (0 if none found)
-static int find_longest(const unsigned char *buf, int start_offset, int max_search, int *found_offset, lookback *lkbk)
+// returns max length of matching stream if at least MIN_MATCH, less otherwise
+//
+// Only positions sharing the first 3 bytes are chained together, which are the
+// only ones that can produce a usable match. All of them within the window are
+// checked and ties go to the farthest one, so the result is the same as
+// checking every previous position.
+static int find_longest(match_finder *mf, int start_offset, int max_search, int *found_offset)
 {
+   const unsigned char *buf = mf->buf;
    int best_length = 0;
    int best_offset = 0;
    int cur_length;
    int search_len;
    int farthest, off, i;
-   int lb_idx;
-   const unsigned char first = buf[start_offset];
-   lookback *lb = &lkbk[first];
 
    // buf
    //  |    off        start                  max
@@ -88,13 +87,21 @@ static int find_longest(const unsigned char *buf, int start_offset, int max_sear
    //        |+i->       |      |+i->
    //                       +cur_length
 
-   // check at most the past 4096 values
-   farthest = MAX(start_offset - 4096, 0);
-   // find starting index
-   for (lb_idx = lb->start; lb_idx < lb->count && lb->indexes[lb_idx] < farthest; lb_idx++) {}
-   lb->start = lb_idx;
-   for ( ; lb_idx < lb->count && lb->indexes[lb_idx] < start_offset; lb_idx++) {
-      off = lb->indexes[lb_idx];
+   *found_offset = 0;
+   if (max_search < MIN_MATCH) {
+      return 0;
+   }
+
+   // chain every position before start
+   for ( ; mf->inserted < start_offset; mf->inserted++) {
+      unsigned int h = hash3(&buf[mf->inserted]);
+      mf->prev[mf->inserted] = mf->head[h];
+      mf->head[h] = mf->inserted;
+   }
+
+   // check at most the past 4096 values, newest first
+   farthest = MAX(start_offset - WINDOW_SIZE, 0);
+   for (off = mf->head[hash3(&buf[start_offset])]; off >= farthest; off = mf->prev[off]) {
       // check at most requested max or up until start
       search_len = MIN(max_search, start_offset - off);
       for (i = 0; i < search_len; i++) {
@@ -114,7 +121,7 @@ static int find_longest(const unsigned char *buf, int start_offset, int max_sear
          }
          cur_length += i;
       }
-      if (cur_length > best_length) {
+      if (cur_length >= best_length) {
          best_offset = start_offset - off;
          best_length = cur_length;
       }
@@ -193,106 +200,176 @@ int mio0_decode(const unsigned char *in, unsigned char *out, unsigned int *end)
    return bytes_written;
 }
 
-int mio0_encode(const unsigned char *in, unsigned int length, unsigned char *out)
+typedef struct
 {
    unsigned char *bit_buf;
    unsigned char *comp_buf;
    unsigned char *uncomp_buf;
+   int bit_idx;
+   int comp_idx;
+   int uncomp_idx;
+} mio0_stream;
+
+static void stream_init(mio0_stream *s, unsigned int length)
+{
+   // allocate some temporary buffers worst case size
+   s->bit_buf = calloc((length + 7) / 8, 1); // 1-bit/byte
+   s->comp_buf = malloc(length); // 16-bits/2bytes
+   s->uncomp_buf = malloc(length); // all uncompressed
+   s->bit_idx = 0;
+   s->comp_idx = 0;
+   s->uncomp_idx = 0;
+}
+
+static inline void stream_put_literal(mio0_stream *s, unsigned char val)
+{
+   s->uncomp_buf[s->uncomp_idx++] = val;
+   PUT_BIT(s->bit_buf, s->bit_idx++, 1);
+}
+
+static inline void stream_put_match(mio0_stream *s, int length, int offset)
+{
+   s->comp_buf[s->comp_idx] = (((length - 3) & 0x0F) << 4) |
+                              (((offset - 1) >> 8) & 0x0F);
+   s->comp_buf[s->comp_idx + 1] = (offset - 1) & 0xFF;
+   s->comp_idx += 2;
+   PUT_BIT(s->bit_buf, s->bit_idx++, 0);
+}
+
+// write header and stream to out, freeing the stream
+static int stream_finish(mio0_stream *s, unsigned int length, unsigned char *out)
+{
    unsigned int bit_length;
    unsigned int comp_offset;
    unsigned int uncomp_offset;
-   unsigned int bytes_proc = 0;
    int bytes_written;
-   int bit_idx = 0;
-   int comp_idx = 0;
-   int uncomp_idx = 0;
-   lookback *lookbacks;
 
-   // initialize lookback buffer
-   lookbacks = lookback_init();
+   // compute final sizes and offsets
+   // +7 so int division accounts for all bits
+   bit_length = ((s->bit_idx + 7) / 8);
+   // compressed data after control bits and aligned to 4-byte boundary
+   comp_offset = ALIGN(MIO0_HEADER_LENGTH + bit_length, 4);
+   uncomp_offset = comp_offset + s->comp_idx;
+   bytes_written = uncomp_offset + s->uncomp_idx;
 
-   // allocate some temporary buffers worst case size
-   bit_buf = malloc((length + 7) / 8); // 1-bit/byte
-   comp_buf = malloc(length); // 16-bits/2bytes
-   uncomp_buf = malloc(length); // all uncompressed
-   memset(bit_buf, 0, (length + 7) / 8);
+   // output header
+   memcpy(out, "MIO0", 4);
+   write_u32_be(&out[4], length);
+   write_u32_be(&out[8], comp_offset);
+   write_u32_be(&out[12], uncomp_offset);
+   // output data
+   memcpy(&out[MIO0_HEADER_LENGTH], s->bit_buf, bit_length);
+   // alignment padding, which would otherwise be whatever was left in out
+   memset(&out[MIO0_HEADER_LENGTH + bit_length], 0, comp_offset - MIO0_HEADER_LENGTH - bit_length);
+   memcpy(&out[comp_offset], s->comp_buf, s->comp_idx);
+   memcpy(&out[uncomp_offset], s->uncomp_buf, s->uncomp_idx);
+
+   // free allocated buffers
+   free(s->bit_buf);
+   free(s->comp_buf);
+   free(s->uncomp_buf);
+
+   return bytes_written;
+}
+
+int mio0_encode(const unsigned char *in, unsigned int length, unsigned char *out)
+{
+   unsigned int bytes_proc = 0;
+   mio0_stream stream;
+   match_finder mf;
+
+   match_finder_init(&mf, in, length);
+   stream_init(&stream, length);
 
    // encode data
    // special case for first byte
-   lookback_push(lookbacks, in[0], 0);
-   uncomp_buf[uncomp_idx] = in[0];
-   uncomp_idx += 1;
+   stream_put_literal(&stream, in[0]);
    bytes_proc += 1;
-   PUT_BIT(bit_buf, bit_idx++, 1);
    while (bytes_proc < length) {
       int offset;
-      int max_length = MIN(length - bytes_proc, 18);
-      int longest_match = find_longest(in, bytes_proc, max_length, &offset, lookbacks);
-      // push current byte before checking next longer match
-      lookback_push(lookbacks, in[bytes_proc], bytes_proc);
+      int max_length = MIN(length - bytes_proc, MAX_MATCH);
+      int longest_match = find_longest(&mf, bytes_proc, max_length, &offset);
       if (longest_match > 2) {
          int lookahead_offset;
          // lookahead to next byte to see if longer match
-         int lookahead_length = MIN(length - bytes_proc - 1, 18);
-         int lookahead_match = find_longest(in, bytes_proc + 1, lookahead_length, &lookahead_offset, lookbacks);
+         int lookahead_length = MIN(length - bytes_proc - 1, MAX_MATCH);
+         int lookahead_match = find_longest(&mf, bytes_proc + 1, lookahead_length, &lookahead_offset);
          // better match found, use uncompressed + lookahead compressed
          if ((longest_match + 1) < lookahead_match) {
             // uncompressed byte
-            uncomp_buf[uncomp_idx] = in[bytes_proc];
-            uncomp_idx++;
-            PUT_BIT(bit_buf, bit_idx, 1);
+            stream_put_literal(&stream, in[bytes_proc]);
             bytes_proc++;
             longest_match = lookahead_match;
             offset = lookahead_offset;
-            bit_idx++;
-            lookback_push(lookbacks, in[bytes_proc], bytes_proc);
-         }
-         // first byte already pushed above
-         for (int i = 1; i < longest_match; i++) {
-            lookback_push(lookbacks, in[bytes_proc + i], bytes_proc + i);
          }
          // compressed block
-         comp_buf[comp_idx] = (((longest_match - 3) & 0x0F) << 4) |
-                              (((offset - 1) >> 8) & 0x0F);
-         comp_buf[comp_idx + 1] = (offset - 1) & 0xFF;
-         comp_idx += 2;
-         PUT_BIT(bit_buf, bit_idx, 0);
+         stream_put_match(&stream, longest_match, offset);
          bytes_proc += longest_match;
       } else {
          // uncompressed byte
-         uncomp_buf[uncomp_idx] = in[bytes_proc];
-         uncomp_idx++;
-         PUT_BIT(bit_buf, bit_idx, 1);
+         stream_put_literal(&stream, in[bytes_proc]);
          bytes_proc++;
       }
-      bit_idx++;
    }
 
-   // compute final sizes and offsets
-   // +7 so int division accounts for all bits
-   bit_length = ((bit_idx + 7) / 8);
-   // compressed data after control bits and aligned to 4-byte boundary
-   comp_offset = ALIGN(MIO0_HEADER_LENGTH + bit_length, 4);
-   uncomp_offset = comp_offset + comp_idx;
-   bytes_written = uncomp_offset + uncomp_idx;
+   match_finder_free(&mf);
 
-   // output header
-   memcpy(out, "MIO0", 4);
-   write_u32_be(&out[4], length);
-   write_u32_be(&out[8], comp_offset);
-   write_u32_be(&out[12], uncomp_offset);
-   // output data
-   memcpy(&out[MIO0_HEADER_LENGTH], bit_buf, bit_length);
-   memcpy(&out[comp_offset], comp_buf, comp_idx);
-   memcpy(&out[uncomp_offset], uncomp_buf, uncomp_idx);
+   return stream_finish(&stream, length, out);
+}
 
-   // free allocated buffers
-   free(bit_buf);
-   free(comp_buf);
-   free(uncomp_buf);
-   lookback_free(lookbacks);
+int mio0_encode_optimal(const unsigned char *in, unsigned int length, unsigned char *out)
+{
+   // cost in bits of encoding from each position to the end
+   unsigned int *cost = malloc((length + 1) * sizeof(*cost));
+   unsigned char *match_length = malloc(MAX(length, 1));
+   unsigned short *match_offset = malloc(MAX(length, 1) * sizeof(*match_offset));
+   unsigned int bytes_proc;
+   mio0_stream stream;
+   match_finder mf;
+   int i;
 
-   return bytes_written;
+   match_finder_init(&mf, in, length);
+   stream_init(&stream, length);
+
+   // longest match at every position; any shorter prefix of it works too
+   for (bytes_proc = 0; bytes_proc < length; bytes_proc++) {
+      int offset;
+      int longest_match = 0;
+      if (bytes_proc > 0) {
+         longest_match = find_longest(&mf, bytes_proc, MIN(length - bytes_proc, MAX_MATCH), &offset);
+      }
+      match_length[bytes_proc] = longest_match >= MIN_MATCH ? longest_match : 0;
+      match_offset[bytes_proc] = longest_match >= MIN_MATCH ? offset : 0;
+   }
+
+   // literals cost a control bit and a byte, matches a control bit and two bytes
+   cost[length] = 0;
+   for (i = length - 1; i >= 0; i--) {
+      int best_length = 1;
+      cost[i] = cost[i + 1] + 9;
+      for (int len = MIN_MATCH; len <= match_length[i]; len++) {
+         if (cost[i + len] + 17 < cost[i]) {
+            cost[i] = cost[i + len] + 17;
+            best_length = len;
+         }
+      }
+      match_length[i] = best_length;
+   }
+
+   for (bytes_proc = 0; bytes_proc < length; bytes_proc += match_length[bytes_proc]) {
+      if (match_length[bytes_proc] == 1) {
+         stream_put_literal(&stream, in[bytes_proc]);
+      } else {
+         stream_put_match(&stream, match_length[bytes_proc], match_offset[bytes_proc]);
+      }
+   }
+
+   match_finder_free(&mf);
+   free(cost);
+   free(match_length);
+   free(match_offset);
+
+   return stream_finish(&stream, length, out);
 }
 
 static FILE *mio0_open_out_file(const char *out_file) {
@@ -382,7 +459,8 @@ free_all:
    return ret_val;
 }
 
-int mio0_encode_file(const char *in_file, const char *out_file)
+static int encode_file(const char *in_file, const char *out_file,
+                       int (*encode)(const unsigned char *, unsigned int, unsigned char *))
 {
    FILE *in;
    FILE *out;
@@ -412,11 +490,12 @@ int mio0_encode_file(const char *in_file, const char *out_file)
       goto free_all;
    }
 
-   // allocate worst case length
-   out_buf = malloc(MIO0_HEADER_LENGTH + ((file_size+7)/8) + file_size);
+   // allocate worst case length: one control bit per byte, padded to 4 bytes,
+   // plus every byte as a literal
+   out_buf = malloc(ALIGN(MIO0_HEADER_LENGTH + ((file_size+7)/8), 4) + file_size);
 
    // compress data in MIO0 format
-   bytes_encoded = mio0_encode(in_buf, file_size, out_buf);
+   bytes_encoded = encode(in_buf, file_size, out_buf);
 
    // open output file
    out = mio0_open_out_file(out_file);
@@ -447,14 +526,34 @@ free_all:
    return ret_val;
 }
 
+int mio0_encode_file(const char *in_file, const char *out_file)
+{
+   return encode_file(in_file, out_file, mio0_encode);
+}
+
+int mio0_encode_file_optimal(const char *in_file, const char *out_file)
+{
+   return encode_file(in_file, out_file, mio0_encode_optimal);
+}
+
 // mio0 standalone executable
 #ifdef MIO0_STANDALONE
+#include <pthread.h>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <unistd.h>
+#endif
+
 typedef struct
 {
    char *in_filename;
    char *out_filename;
    unsigned int offset;
    int compress;
+   int optimal;
+   int batch;
+   int jobs;
+   char **batch_files;
+   int batch_count;
 } arg_config;
 
 static arg_config default_config =
@@ -462,19 +561,28 @@ static arg_config default_config =
    NULL,
    NULL,
    0,
-   1
+   1,
+   0,
+   0,
+   0,
+   NULL,
+   0
 };
 
 static void print_usage(void)
 {
-   ERROR("Usage: mio0 [-c / -d] [-o OFFSET] FILE [OUTPUT]\n"
+   ERROR("Usage: mio0 [-c / -d] [-p] [-o OFFSET] FILE [OUTPUT]\n"
+         "       mio0 -b [-p] [-j JOBS] FILE OUTPUT [FILE OUTPUT ...]\n"
          "\n"
          "mio0 v" MIO0_VERSION ": MIO0 compression and decompression tool\n"
          "\n"
          "Optional arguments:\n"
          " -c           compress raw data into MIO0 (default: compress)\n"
          " -d           decompress MIO0 into raw data\n"
+         " -p           pick matches for the smallest output (differs from original tools)\n"
          " -o OFFSET    starting offset in FILE (default: 0)\n"
+         " -b           compress every FILE into the OUTPUT following it\n"
+         " -j JOBS      number of files to compress at once in batch mode (default: CPU count)\n"
          "\n"
          "File arguments:\n"
          " FILE        input file\n"
@@ -500,6 +608,18 @@ static void parse_arguments(int argc, char *argv[], arg_config *config)
             case 'd':
                config->compress = 0;
                break;
+            case 'p':
+               config->optimal = 1;
+               break;
+            case 'b':
+               config->batch = 1;
+               break;
+            case 'j':
+               if (++i >= argc) {
+                  print_usage();
+               }
+               config->jobs = strtoul(argv[i], NULL, 0);
+               break;
             case 'o':
                if (++i >= argc) {
                   print_usage();
@@ -510,6 +630,14 @@ static void parse_arguments(int argc, char *argv[], arg_config *config)
                print_usage();
                break;
          }
+      } else if (config->batch) {
+         // remaining arguments are all file pairs
+         config->batch_files = &argv[i];
+         config->batch_count = (argc - i) / 2;
+         if ((argc - i) % 2 != 0 || !config->compress) {
+            print_usage();
+         }
+         return;
       } else {
          switch (file_count) {
             case 0:
@@ -530,6 +658,99 @@ static void parse_arguments(int argc, char *argv[], arg_config *config)
    }
 }
 
+static void print_error(int ret_val, const arg_config *config)
+{
+   switch (ret_val) {
+      case 1:
+         ERROR("Error opening input file \"%s\"\n", config->in_filename);
+         break;
+      case 2:
+         ERROR("Error reading from input file \"%s\"\n", config->in_filename);
+         break;
+      case 3:
+         ERROR("Error decoding MIO0 data. Wrong offset (0x%X)?\n", config->offset);
+         break;
+      case 4:
+         ERROR("Error opening output file \"%s\"\n", config->out_filename);
+         break;
+      case 5:
+         ERROR("Error writing bytes to output file \"%s\"\n", config->out_filename);
+         break;
+   }
+}
+
+typedef struct
+{
+   const arg_config *config;
+   pthread_mutex_t lock;
+   int next;
+   int ret_val;
+} batch_state;
+
+static void *batch_worker(void *arg)
+{
+   batch_state *state = arg;
+   arg_config file_config = *state->config;
+   int ret_val;
+   int idx;
+
+   for (;;) {
+      pthread_mutex_lock(&state->lock);
+      idx = state->next++;
+      pthread_mutex_unlock(&state->lock);
+      if (idx >= file_config.batch_count) {
+         break;
+      }
+      file_config.in_filename = file_config.batch_files[idx * 2];
+      file_config.out_filename = file_config.batch_files[idx * 2 + 1];
+      if (file_config.optimal) {
+         ret_val = mio0_encode_file_optimal(file_config.in_filename, file_config.out_filename);
+      } else {
+         ret_val = mio0_encode_file(file_config.in_filename, file_config.out_filename);
+      }
+      if (ret_val != 0) {
+         pthread_mutex_lock(&state->lock);
+         print_error(ret_val, &file_config);
+         state->ret_val = ret_val;
+         pthread_mutex_unlock(&state->lock);
+      }
+   }
+   return NULL;
+}
+
+// compress all file pairs, each file on a single worker
+static int batch_encode(const arg_config *config)
+{
+   pthread_t *threads;
+   batch_state state;
+   int jobs = config->jobs;
+   int i;
+
+   if (jobs <= 0) {
+#if defined(_SC_NPROCESSORS_ONLN)
+      jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      jobs = MAX(jobs, 1);
+   }
+   jobs = MIN(jobs, config->batch_count);
+
+   state.config = config;
+   state.next = 0;
+   state.ret_val = 0;
+   pthread_mutex_init(&state.lock, NULL);
+   threads = malloc(MAX(jobs, 1) * sizeof(*threads));
+   for (i = 0; i < jobs; i++) {
+      pthread_create(&threads[i], NULL, batch_worker, &state);
+   }
+   for (i = 0; i < jobs; i++) {
+      pthread_join(threads[i], NULL);
+   }
+   pthread_mutex_destroy(&state.lock);
+   free(threads);
+
+   return state.ret_val;
+}
+
 int main(int argc, char *argv[])
 {
    char out_filename[FILENAME_MAX];
@@ -539,35 +760,24 @@ int main(int argc, char *argv[])
    // get configuration from arguments
    config = default_config;
    parse_arguments(argc, argv, &config);
+   if (config.batch) {
+      return batch_encode(&config);
+   }
    if (config.out_filename == NULL) {
       config.out_filename = out_filename;
       sprintf(config.out_filename, "%s.out", config.in_filename);
    }
 
    // operation
-   if (config.compress) {
-      ret_val = mio0_encode_file(config.in_filename, config.out_filename);
-   } else {
+   if (!config.compress) {
       ret_val = mio0_decode_file(config.in_filename, config.offset, config.out_filename);
+   } else if (config.optimal) {
+      ret_val = mio0_encode_file_optimal(config.in_filename, config.out_filename);
+   } else {
+      ret_val = mio0_encode_file(config.in_filename, config.out_filename);
    }
 
-   switch (ret_val) {
-      case 1:
-         ERROR("Error opening input file \"%s\"\n", config.in_filename);
-         break;
-      case 2:
-         ERROR("Error reading from input file \"%s\"\n", config.in_filename);
-         break;
-      case 3:
-         ERROR("Error decoding MIO0 data. Wrong offset (0x%X)?\n", config.offset);
-         break;
-      case 4:
-         ERROR("Error opening output file \"%s\"\n", config.out_filename);
-         break;
-      case 5:
-         ERROR("Error writing bytes to output file \"%s\"\n", config.out_filename);
-         break;
-   }
+   print_error(ret_val, &config);
 
    return ret_val;
 }
@@ -32,10 +32,14 @@ int mio0_decode(const unsigned char *in, unsigned char *out, unsigned int *end);
 
 // encode MIO0 data in memory
 // in: buffer containing raw data
-// out: buffer for MIO0 data
+// out: buffer for MIO0 data, at least ALIGN(MIO0_HEADER_LENGTH + (length+7)/8, 4) + length bytes
 // returns size of compressed data in 'out' including MIO0 header
 int mio0_encode(const unsigned char *in, unsigned int length, unsigned char *out);
 
+// encode MIO0 data in memory, choosing matches for the smallest output
+// same arguments as mio0_encode, but output differs from the original tools
+int mio0_encode_optimal(const unsigned char *in, unsigned int length, unsigned char *out);
+
 // decode an entire MIO0 block at an offset from file to output file
 // in_file: input filename
 // offset: offset to start decoding from in_file
@@ -47,4 +51,7 @@ int mio0_decode_file(const char *in_file, unsigned long offset, const char *out_
 // out_file: output filename to write MIO0 compressed data to
 int mio0_encode_file(const char *in_file, const char *out_file);
 
+// encode an entire file with mio0_encode_optimal
+int mio0_encode_file_optimal(const char *in_file, const char *out_file);
+
 #endif // LIBMIO0_H_
@@ -505,30 +505,36 @@ ia *png2ia(const char *png_filename, int *width, int *height)
 
 // find index of palette color
 // return -1 if not found
-static int pal_find_color(const palette_t *pal, uint16_t val)
+// hash table from color to palette index, so every pixel doesn't need to
+// search the whole palette
+#define PAL_HASH_SIZE 512 // power of 2, at least twice the largest palette
+
+static inline unsigned pal_hash(uint16_t val)
 {
-   for (int i = 0; i < pal->used; i++) {
-      if (pal->data[i] == val) {
-         return i;
-      }
-   }
-   return -1;
+   return (val * 40503u >> 7) & (PAL_HASH_SIZE - 1);
 }
 
 // find value in palette, or add if not there
+// hash: PAL_HASH_SIZE entries of palette index + 1, 0 when empty
 // returns palette index entered or -1 if palette full
-static int pal_add_color(palette_t *pal, uint16_t val)
+static int pal_add_color(palette_t *pal, uint16_t *hash, uint16_t val)
 {
+   unsigned slot = pal_hash(val);
    int idx;
-   idx = pal_find_color(pal, val);
-   if (idx < 0) {
-      if (pal->used == pal->max) {
-         ERROR("Error: trying to use more than %d\n", pal->max);
-      } else {
-         idx = pal->used;
-         pal->data[pal->used] = val;
-         pal->used++;
+   while (hash[slot] != 0) {
+      if (pal->data[hash[slot] - 1] == val) {
+         return hash[slot] - 1;
       }
+      slot = (slot + 1) & (PAL_HASH_SIZE - 1);
+   }
+   if (pal->used == pal->max) {
+      ERROR("Error: trying to use more than %d\n", pal->max);
+      idx = -1;
+   } else {
+      idx = pal->used;
+      pal->data[pal->used] = val;
+      pal->used++;
+      hash[slot] = idx + 1;
    }
    return idx;
 }
@@ -537,13 +543,14 @@ static int pal_add_color(palette_t *pal, uint16_t val)
 // returns 1 on success
 int raw2ci(uint8_t *rawci, palette_t *pal, const uint8_t *raw, int raw_len, int ci_depth)
 {
+   uint16_t hash[PAL_HASH_SIZE] = {0};
    // assign colors to palette
    pal->used = 0;
    memset(pal->data, 0, sizeof(pal->data));
    int ci_idx = 0;
    for (int i = 0; i < raw_len; i += sizeof(uint16_t)) {
       uint16_t val = read_u16_be(&raw[i]);
-      int pal_idx = pal_add_color(pal, val);
+      int pal_idx = pal_add_color(pal, hash, val);
       if (pal_idx < 0) {
          ERROR("Error adding color @ (%d): %d (used: %d/%d)\n", i, pal_idx, pal->used, pal->max);
          return 0;
@@ -58,6 +58,11 @@ int fprint_write_output(FILE *fp, write_encoding encoding, const uint8_t *raw, i
       [ENCODING_U32] = {sizeof(uint32_t), ""},
       [ENCODING_U64] = {sizeof(uint64_t), "ULL"},
    };
+   static const char hex[] = "0123456789abcdef";
+   // values are formatted here and written out in large chunks, since calling
+   // fprintf for every byte dominated the run time
+   char buf[4096];
+   int buf_len = 0;
    int flength = 0;
    const encoding_format *fmt = &enc_fmt[encoding];
    switch (encoding) {
@@ -69,13 +74,25 @@ int fprint_write_output(FILE *fp, write_encoding encoding, const uint8_t *raw, i
       case ENCODING_U32:
       case ENCODING_U64:
          for (int w = 0; w < length; w += fmt->bytes_per_val) {
-            flength += fprintf(fp, "0x");
+            // "0x" + 16 hex digits + "ULL" + separator at most
+            if (buf_len > (int)sizeof(buf) - 32) {
+               flength += fwrite(buf, 1, buf_len, fp);
+               buf_len = 0;
+            }
+            buf[buf_len++] = '0';
+            buf[buf_len++] = 'x';
             for (int b = 0; b < fmt->bytes_per_val; b++) {
                int off = w + b;
-               flength += fprintf(fp, "%02x", off < length ? raw[off] : 0x00);
+               uint8_t val = off < length ? raw[off] : 0x00;
+               buf[buf_len++] = hex[val >> 4];
+               buf[buf_len++] = hex[val & 0xF];
+            }
+            for (const char *s = fmt->suffix; *s != '\0'; s++) {
+               buf[buf_len++] = *s;
             }
-            flength += fprintf(fp, "%s%c", fmt->suffix, (w < length - fmt->bytes_per_val) ? ',' : '\n');
+            buf[buf_len++] = (w < length - fmt->bytes_per_val) ? ',' : '\n';
          }
+         flength += fwrite(buf, 1, buf_len, fp);
          break;
    }
    return flength;
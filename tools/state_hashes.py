@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Prints the per-frame state hashes logged during demo playback by a game built
+# with STATE_HASH, or compares the logs from two RAM dumps and reports the first
+# frame where the simulations diverge.
+import sys
+import re
+import struct
+
+RAM_BASE = 0x80000000
+# must match STATE_HASH_LOG_SIZE in src/game/game_init.c
+STATE_HASH_LOG_SIZE = 2048
+
+
+def read_map(filename):
+    symbols = {}
+    with open(filename, "r") as f:
+        for line in f:
+            m = re.match(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_]\w*)\s*$", line)
+            if m:
+                symbols[m.group(2)] = int(m.group(1), 16) & 0xFFFFFFFF
+    return symbols
+
+
+def read_hashes(filename, symbols):
+    with open(filename, "rb") as f:
+        ram = f.read()
+
+    def read_u32(addr):
+        off = addr - RAM_BASE
+        return struct.unpack(">I", ram[off : off + 4])[0]
+
+    frames = read_u32(symbols["gStateHashFrames"])
+    log = symbols["gStateHashLog"]
+    # only the last STATE_HASH_LOG_SIZE frames are still in the ring
+    first = max(0, frames - STATE_HASH_LOG_SIZE)
+    return {
+        frame: read_u32(log + (frame % STATE_HASH_LOG_SIZE) * 4)
+        for frame in range(first, frames)
+    }
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print("Usage: {} <sm64.map> <ram dump> [<ram dump 2>]".format(sys.argv[0]))
+        print("The RAM dumps are big-endian RDRAM starting at 0x80000000.")
+        sys.exit(1)
+
+    symbols = read_map(sys.argv[1])
+    for name in ["gStateHashLog", "gStateHashFrames"]:
+        if name not in symbols:
+            print("{} not found in map; was the game built with STATE_HASH?".format(name))
+            sys.exit(1)
+
+    a = read_hashes(sys.argv[2], symbols)
+    if len(sys.argv) == 3:
+        for frame in sorted(a):
+            print("%6d %08X" % (frame, a[frame]))
+        return
+
+    b = read_hashes(sys.argv[3], symbols)
+    common = sorted(set(a) & set(b))
+    if not common:
+        print("no frames in common (%d and %d frames logged)" % (len(a), len(b)))
+        sys.exit(1)
+    for frame in common:
+        if a[frame] != b[frame]:
+            print("diverged at frame %d: %08X != %08X" % (frame, a[frame], b[frame]))
+            sys.exit(1)
+    print("frames %d-%d identical" % (common[0], common[-1]))
+
+
+if __name__ == "__main__":
+    main()